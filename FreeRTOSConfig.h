@@ -66,15 +66,20 @@
  * See http://www.freertos.org/a00110.html.
  *----------------------------------------------------------*/
 
+/* The heap size is set by the RAM budget profile. */
+#include "mem_profile.h"
+
 #define configUSE_PREEMPTION                1
-#define configUSE_IDLE_HOOK                 1
-#define configUSE_TICK_HOOK                 0
+#define configUSE_TICKLESS_IDLE             1
+#define configUSE_IDLE_HOOK                 0
+#define configUSE_TICK_HOOK                 1
 #define configCPU_CLOCK_HZ                  ( ( unsigned long ) 80000000 )
 #define configTICK_RATE_HZ                  ( ( portTickType ) 1000 )
 #define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 200 )
-#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 20240 ) )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( PROFILE_TOTAL_HEAP_SIZE ) )
 #define configMAX_TASK_NAME_LEN             ( 12 )
 #define configUSE_TRACE_FACILITY            1
+#define configGENERATE_RUN_TIME_STATS       1
 #define configUSE_16_BIT_TICKS              0
 #define configIDLE_SHOULD_YIELD             0
 #define configUSE_CO_ROUTINES               0
@@ -87,16 +92,64 @@
 #define configQUEUE_REGISTRY_SIZE           10
 
 /* Set the following definitions to 1 to include the API function, or zero
-to exclude the API function. */
+to exclude the API function.  vTaskDelete() is excluded since the application
+tasks run on static stacks, which it would free to the heap (see
+mem_profile.h). */
 
 #define INCLUDE_vTaskPrioritySet            1
 #define INCLUDE_uxTaskPriorityGet           1
-#define INCLUDE_vTaskDelete                 1
+#define INCLUDE_vTaskDelete                 0
 #define INCLUDE_vTaskCleanUpResources       0
 #define INCLUDE_vTaskSuspend                1
 #define INCLUDE_vTaskDelayUntil             1
 #define INCLUDE_vTaskDelay                  1
 #define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTaskGetIdleTaskHandle      1
+#define INCLUDE_pcTaskGetTaskName           1
+
+/* Report task creation and deletion to the status task, which displays the
+number of tasks.  These are called by the kernel from within a critical
+section. */
+extern void StatusTaskCreated(void);
+extern void StatusTaskDeleted(void);
+#define traceTASK_CREATE(pxNewTCB)          StatusTaskCreated()
+#define traceTASK_DELETE(pxTCB)             StatusTaskDeleted()
+
+/* Collect the run time of each task from the timer used for the CPU load,
+which is started by CPULoadInit() in main(). */
+#include "cpu_time.h"
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()    CPULoadRunTimeGet()
+
+/* Stop the tick while the idle task runs and sleep until the next task is due
+to run or an interrupt occurs.  See vPortSuppressTicksAndSleep() in port.c. */
+extern void vPortSuppressTicksAndSleep( unsigned long xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+/* Measure the time spent in the idle task for the CPU load (see cpu_load.c).
+These are called by the kernel from within a critical section. */
+extern void CPULoadTaskSwitchedIn(_Bool bIdle);
+extern void CPULoadTaskSwitchedOut(void);
+#define traceTASK_SWITCHED_OUT()            CPULoadTaskSwitchedOut()
+
+/* Record context switches and queue, semaphore and mutex operations in the
+trace ring served as /sys/trace (see trace.c).  The switch in is also reported
+to the CPU load measurement above. */
+extern void TraceTaskSwitchedIn(unsigned long ulTask);
+extern void TraceQueueSend(void *pvQueue);
+extern void TraceQueueReceive(void *pvQueue);
+#define traceTASK_SWITCHED_IN()                                               \
+    do                                                                        \
+    {                                                                         \
+        CPULoadTaskSwitchedIn(pxCurrentTCB == xIdleTaskHandle);               \
+        TraceTaskSwitchedIn(pxCurrentTCB->uxTCBNumber);                       \
+    }                                                                         \
+    while(0)
+#define traceQUEUE_SEND(pxQueue)            TraceQueueSend(pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)   TraceQueueSend(pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)         TraceQueueReceive(pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) TraceQueueReceive(pxQueue)
 
 /* Be ENORMOUSLY careful if you want to modify these two values and make sure
  * you read http://www.freertos.org/a00110.html#kernel_priority first!
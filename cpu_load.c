@@ -0,0 +1,252 @@
+//*****************************************************************************
+//
+// cpu_load.c - CPU load measurement.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cpu_load.h"
+
+//*****************************************************************************
+//
+// The load is measured as the share of each window that the idle task was not
+// running.  Time is read from a free-running 32-bit timer clocked at the
+// system clock rather than from the SysTick or the cycle counter: the SysTick
+// is reprogrammed while the kernel suppresses ticks in tickless idle, and the
+// cycle counter stops while the core sleeps, both of which would hide the
+// time spent idle.
+//
+// The kernel reports every context switch.  The time between the idle task
+// being switched in and out is added to the idle time of the current window,
+// and the tick hook closes the window once it is CPU_LOAD_WINDOW_MS long,
+// crediting the idle task with the part of its time slice so far.  While ticks
+// are suppressed the window closes on the first tick after the sleep, so a
+// window may be somewhat longer than CPU_LOAD_WINDOW_MS; its actual length is
+// reported along with the load.
+//
+// The switch hooks and the tick hook all run with interrupts masked up to the
+// kernel priority, so they need no further locking.
+//
+//*****************************************************************************
+#define CPU_LOAD_TIMER_BASE     TIMER4_BASE
+#define CPU_LOAD_TIMER_PERIPH   SYSCTL_PERIPH_TIMER4
+
+static uint32_t g_ui32WindowLength;
+static uint32_t g_ui32WindowStart;
+static uint32_t g_ui32IdleStart;
+static uint32_t g_ui32IdleTime;
+static bool g_bIdle;
+static tCPULoad g_sLoad;
+
+//*****************************************************************************
+//
+// The kernel's run-time statistics counter.  It is the free-running timer
+// divided by 2^CPU_LOAD_RUN_TIME_SHIFT, extended in software to a full 32
+// bits.  It runs for just under an hour before wrapping at an 80 MHz system
+// clock, rather than the 53 seconds of the timer itself.  The tick hook keeps the extension
+// up to date while ticks are suppressed, since the timer must not wrap twice
+// between updates.
+//
+//*****************************************************************************
+static uint32_t g_ui32SysClock;
+static uint32_t g_ui32RunTimeLast;
+static uint32_t g_ui32RunTimeFrac;
+static uint32_t g_ui32RunTime;
+
+//*****************************************************************************
+//
+// Starts the timer used to measure the CPU load.  Must be called before the
+// scheduler is started.
+//
+//*****************************************************************************
+void
+CPULoadInit(uint32_t ui32SysClock)
+{
+    SysCtlPeripheralEnable(CPU_LOAD_TIMER_PERIPH);
+    while(!SysCtlPeripheralReady(CPU_LOAD_TIMER_PERIPH))
+    {
+    }
+
+    TimerConfigure(CPU_LOAD_TIMER_BASE, TIMER_CFG_PERIODIC_UP);
+    TimerLoadSet(CPU_LOAD_TIMER_BASE, TIMER_A, 0xffffffff);
+    TimerEnable(CPU_LOAD_TIMER_BASE, TIMER_A);
+
+    g_ui32SysClock = ui32SysClock;
+    g_ui32WindowLength = (ui32SysClock / 1000) * CPU_LOAD_WINDOW_MS;
+    g_ui32WindowStart = CPULoadTimeGet();
+    g_ui32RunTimeLast = g_ui32WindowStart;
+}
+
+//*****************************************************************************
+//
+// Returns the current value of the free-running timer, in system clock ticks.
+// It wraps every 2^32 ticks.
+//
+//*****************************************************************************
+uint32_t
+CPULoadTimeGet(void)
+{
+    return(HWREG(CPU_LOAD_TIMER_BASE + TIMER_O_TAV));
+}
+
+//*****************************************************************************
+//
+// Returns the rate of the free-running timer, in Hz.
+//
+//*****************************************************************************
+uint32_t
+CPULoadTimeRateGet(void)
+{
+    return(g_ui32SysClock);
+}
+
+//*****************************************************************************
+//
+// Returns the run-time statistics counter (portGET_RUN_TIME_COUNTER_VALUE).
+// May be called from any context.
+//
+//*****************************************************************************
+uint32_t
+CPULoadRunTimeGet(void)
+{
+    uint32_t ui32Now, ui32Mask, ui32RunTime;
+
+    ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    ui32Now = CPULoadTimeGet();
+    g_ui32RunTimeFrac += ui32Now - g_ui32RunTimeLast;
+    g_ui32RunTimeLast = ui32Now;
+    g_ui32RunTime += g_ui32RunTimeFrac >> CPU_LOAD_RUN_TIME_SHIFT;
+    g_ui32RunTimeFrac &= (1 << CPU_LOAD_RUN_TIME_SHIFT) - 1;
+    ui32RunTime = g_ui32RunTime;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+
+    return(ui32RunTime);
+}
+
+//*****************************************************************************
+//
+// Returns the rate of the run-time statistics counter, in Hz.
+//
+//*****************************************************************************
+uint32_t
+CPULoadRunTimeRateGet(void)
+{
+    return(g_ui32SysClock >> CPU_LOAD_RUN_TIME_SHIFT);
+}
+
+//*****************************************************************************
+//
+// Called by the kernel (traceTASK_SWITCHED_IN) when a task is switched in.
+// bIdle is true if it is the idle task.
+//
+//*****************************************************************************
+void
+CPULoadTaskSwitchedIn(bool bIdle)
+{
+    if(bIdle)
+    {
+        g_ui32IdleStart = CPULoadTimeGet();
+    }
+    g_bIdle = bIdle;
+}
+
+//*****************************************************************************
+//
+// Called by the kernel (traceTASK_SWITCHED_OUT) before a task is switched
+// out.
+//
+//*****************************************************************************
+void
+CPULoadTaskSwitchedOut(void)
+{
+    if(g_bIdle)
+    {
+        g_ui32IdleTime += CPULoadTimeGet() - g_ui32IdleStart;
+        g_bIdle = false;
+    }
+}
+
+//*****************************************************************************
+//
+// The FreeRTOS tick hook.  Closes the measurement window once it is complete.
+//
+//*****************************************************************************
+void
+vApplicationTickHook(void)
+{
+    uint32_t ui32Now, ui32Window, ui32Idle;
+
+    CPULoadRunTimeGet();
+
+    ui32Now = CPULoadTimeGet();
+    ui32Window = ui32Now - g_ui32WindowStart;
+    if(ui32Window < g_ui32WindowLength)
+    {
+        return;
+    }
+
+    //
+    // Credit the idle task with its time so far if it is running, and start
+    // the next window.
+    //
+    if(g_bIdle)
+    {
+        g_ui32IdleTime += ui32Now - g_ui32IdleStart;
+        g_ui32IdleStart = ui32Now;
+    }
+    ui32Idle = g_ui32IdleTime;
+    g_ui32IdleTime = 0;
+    g_ui32WindowStart = ui32Now;
+
+    if(ui32Idle > ui32Window)
+    {
+        ui32Idle = ui32Window;
+    }
+
+    g_sLoad.ui32LoadCenti = (uint32_t)(((uint64_t)(ui32Window - ui32Idle) *
+                                        10000) / ui32Window);
+    g_sLoad.ui32IdleTime = ui32Idle;
+    g_sLoad.ui32WindowTime = ui32Window;
+    g_sLoad.ui32Windows++;
+}
+
+//*****************************************************************************
+//
+// Returns the CPU load over the last complete measurement window.
+//
+//*****************************************************************************
+void
+CPULoadGet(tCPULoad *psLoad)
+{
+    taskENTER_CRITICAL();
+    *psLoad = g_sLoad;
+    taskEXIT_CRITICAL();
+}
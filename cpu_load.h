@@ -0,0 +1,89 @@
+//*****************************************************************************
+//
+// cpu_load.h - Prototypes for the CPU load measurement.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __CPU_LOAD_H__
+#define __CPU_LOAD_H__
+
+#include "cpu_time.h"
+
+//*****************************************************************************
+//
+// The length of a measurement window, in milliseconds.  The load reported is
+// that of the last complete window.
+//
+//*****************************************************************************
+#define CPU_LOAD_WINDOW_MS      1000
+
+//*****************************************************************************
+//
+// The run-time statistics counter runs at the system clock divided by 2 to
+// the power of this.
+//
+//*****************************************************************************
+#define CPU_LOAD_RUN_TIME_SHIFT 6
+
+//*****************************************************************************
+//
+// The CPU load over the last complete measurement window.  Times are in
+// ticks of the system clock.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The share of the window not spent in the idle task, in hundredths of a
+    // percent (0 to 10000).
+    //
+    uint32_t ui32LoadCenti;
+
+    //
+    // The time spent in the idle task, including time asleep.
+    //
+    uint32_t ui32IdleTime;
+
+    //
+    // The length of the window.  0 until the first window completes.
+    //
+    uint32_t ui32WindowTime;
+
+    //
+    // The number of windows completed since boot.
+    //
+    uint32_t ui32Windows;
+}
+tCPULoad;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void CPULoadInit(uint32_t ui32SysClock);
+extern uint32_t CPULoadTimeRateGet(void);
+extern uint32_t CPULoadRunTimeRateGet(void);
+extern void CPULoadTaskSwitchedIn(bool bIdle);
+extern void CPULoadTaskSwitchedOut(void);
+extern void CPULoadGet(tCPULoad *psLoad);
+
+#endif // __CPU_LOAD_H__
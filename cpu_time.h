@@ -0,0 +1,39 @@
+//*****************************************************************************
+//
+// cpu_time.h - Prototypes for the free-running timer of the CPU load
+//              measurement, for use by the FreeRTOS and lwIP configuration.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __CPU_TIME_H__
+#define __CPU_TIME_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Prototypes.  See cpu_load.c.
+//
+//*****************************************************************************
+extern uint32_t CPULoadTimeGet(void);
+extern uint32_t CPULoadRunTimeGet(void);
+
+#endif // __CPU_TIME_H__
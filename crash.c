@@ -0,0 +1,307 @@
+//*****************************************************************************
+//
+// crash.c - Records the cause of a crash across the reset that follows it.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/sysctl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+#include "crash.h"
+
+//*****************************************************************************
+//
+// A hard fault, or a stack overflow detected by the kernel, is recorded in a
+// part of the SRAM that the C start-up code does not initialize (the .noinit
+// section, see freertos_demo_ccs.cmd), after which the processor is reset at
+// once rather than left spinning.  The record survives the reset, so at the
+// next boot CrashInit() picks it up and /sys/crash reports it.
+//
+// The record includes the last CRASH_TRACE_EVENTS events of the trace, which
+// show what the tasks and interrupts were doing up to the crash.
+//
+// At power on the section holds whatever the SRAM came up with, so the record
+// carries a magic number and a check word and is only used when both match.
+// It also counts the crashes recorded since it was last found invalid.
+//
+// The fault handler, CrashFaultISR in crash_isr.asm, finds the stack the
+// processor saved the registers on and passes it, with the exception return
+// value, to CrashFaultCapture().  The frame is only read if it lies within
+// the SRAM, since a fault taken on a corrupt stack pointer would otherwise
+// fault again and lock up the processor.
+//
+//*****************************************************************************
+#define CRASH_MAGIC             0x48535243  // "CRSH"
+
+#define CRASH_SRAM_BASE         0x20000000
+#define CRASH_SRAM_SIZE         0x00040000
+
+typedef struct
+{
+    //
+    // CRASH_MAGIC when the record is valid.
+    //
+    uint32_t ui32Magic;
+
+    //
+    // The number of crashes recorded, and whether the last one has not yet
+    // been picked up by CrashInit().
+    //
+    uint32_t ui32Count;
+    uint32_t ui32Pending;
+
+    //
+    // The last crash.
+    //
+    tCrash sCrash;
+
+    //
+    // The check word over everything above.
+    //
+    uint32_t ui32Check;
+}
+tCrashRecord;
+
+#pragma DATA_SECTION(g_sCrashRecord, ".noinit")
+static tCrashRecord g_sCrashRecord;
+
+//*****************************************************************************
+//
+// The record as found at boot, and the cause of the reset.
+//
+//*****************************************************************************
+static tCrash g_sCrash;
+static uint32_t g_ui32Count;
+static bool g_bNew;
+static uint32_t g_ui32ResetCause;
+
+//*****************************************************************************
+//
+// Returns the check word of the record.
+//
+//*****************************************************************************
+static uint32_t
+CrashCheck(void)
+{
+    const uint32_t *pui32Word;
+    uint32_t ui32Check;
+
+    ui32Check = CRASH_MAGIC;
+    for(pui32Word = (const uint32_t *)&g_sCrashRecord;
+        pui32Word < &g_sCrashRecord.ui32Check; pui32Word++)
+    {
+        ui32Check = ((ui32Check << 5) | (ui32Check >> 27)) ^ *pui32Word;
+    }
+
+    return(ui32Check);
+}
+
+//*****************************************************************************
+//
+// Starts a new crash in the record, keeping the count if the record is
+// valid.
+//
+//*****************************************************************************
+static tCrash *
+CrashBegin(uint32_t ui32Cause)
+{
+    tCrash *psCrash = &g_sCrashRecord.sCrash;
+
+    if((g_sCrashRecord.ui32Magic != CRASH_MAGIC) ||
+       (g_sCrashRecord.ui32Check != CrashCheck()))
+    {
+        g_sCrashRecord.ui32Magic = CRASH_MAGIC;
+        g_sCrashRecord.ui32Count = 0;
+    }
+
+    memset(psCrash, 0, sizeof(*psCrash));
+    psCrash->ui32Cause = ui32Cause;
+    psCrash->ui32Uptime = xTaskGetTickCountFromISR() * portTICK_RATE_MS;
+    psCrash->ui32HeapFree = xPortGetFreeHeapSize();
+    psCrash->ui32TraceCount = TraceLastGet(psCrash->psTrace,
+                                           CRASH_TRACE_EVENTS);
+
+    return(psCrash);
+}
+
+//*****************************************************************************
+//
+// Copies a task name into the record.
+//
+//*****************************************************************************
+static void
+CrashTaskSet(tCrash *psCrash, const char *pcTask)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0;
+        (ui32Idx < (configMAX_TASK_NAME_LEN - 1)) && pcTask[ui32Idx];
+        ui32Idx++)
+    {
+        psCrash->pcTask[ui32Idx] = pcTask[ui32Idx];
+    }
+}
+
+//*****************************************************************************
+//
+// Completes the record and resets the processor.
+//
+//*****************************************************************************
+static void
+CrashEnd(void)
+{
+    g_sCrashRecord.ui32Count++;
+    g_sCrashRecord.ui32Pending = 1;
+    g_sCrashRecord.ui32Check = CrashCheck();
+
+    ROM_SysCtlReset();
+
+    while(1)
+    {
+    }
+}
+
+//*****************************************************************************
+//
+// Records a fault and resets the processor.  Called by CrashFaultISR with the
+// stack the registers were saved on and the exception return value.
+//
+//*****************************************************************************
+void
+CrashFaultCapture(uint32_t *pui32SP, uint32_t ui32ExcReturn)
+{
+    tCrash *psCrash;
+    uint32_t ui32Idx;
+
+    psCrash = CrashBegin(CRASH_CAUSE_FAULT);
+
+    //
+    // Name the running task, unless the fault is from before the scheduler
+    // started.
+    //
+    if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+    {
+        CrashTaskSet(psCrash, (const char *)pcTaskGetTaskName(NULL));
+    }
+
+    psCrash->ui32SP = (uint32_t)pui32SP;
+    psCrash->ui32ExcReturn = ui32ExcReturn;
+    if((((uint32_t)pui32SP & 3) == 0) &&
+       ((uint32_t)pui32SP >= CRASH_SRAM_BASE) &&
+       ((uint32_t)pui32SP <= (CRASH_SRAM_BASE + CRASH_SRAM_SIZE -
+                              (CRASH_NUM_REGS * 4))))
+    {
+        for(ui32Idx = 0; ui32Idx < CRASH_NUM_REGS; ui32Idx++)
+        {
+            psCrash->pui32Frame[ui32Idx] = pui32SP[ui32Idx];
+        }
+        psCrash->ui32Flags |= CRASH_FLAG_FRAME;
+    }
+
+    psCrash->ui32CFSR = HWREG(NVIC_FAULT_STAT);
+    psCrash->ui32HFSR = HWREG(NVIC_HFAULT_STAT);
+    psCrash->ui32MMFAR = HWREG(NVIC_MM_ADDR);
+    psCrash->ui32BFAR = HWREG(NVIC_FAULT_ADDR);
+
+    CrashEnd();
+}
+
+//*****************************************************************************
+//
+// Records a stack overflow and resets the processor.  Called from the
+// kernel's stack overflow hook.
+//
+//*****************************************************************************
+void
+CrashStackOverflow(const char *pcTask)
+{
+    tCrash *psCrash;
+
+    psCrash = CrashBegin(CRASH_CAUSE_STACK);
+    CrashTaskSet(psCrash, pcTask);
+
+    CrashEnd();
+}
+
+//*****************************************************************************
+//
+// Picks up the record of a crash before the last reset, and the cause of the
+// reset.  Must be called once at boot, before the scheduler is started.
+//
+//*****************************************************************************
+void
+CrashInit(void)
+{
+    g_ui32ResetCause = ROM_SysCtlResetCauseGet();
+    ROM_SysCtlResetCauseClear(g_ui32ResetCause);
+
+    if((g_sCrashRecord.ui32Magic == CRASH_MAGIC) &&
+       (g_sCrashRecord.ui32Check == CrashCheck()))
+    {
+        g_ui32Count = g_sCrashRecord.ui32Count;
+        g_sCrash = g_sCrashRecord.sCrash;
+        g_bNew = (g_sCrashRecord.ui32Pending != 0);
+        g_sCrashRecord.ui32Pending = 0;
+    }
+    else
+    {
+        memset(&g_sCrashRecord, 0, sizeof(g_sCrashRecord));
+        g_sCrashRecord.ui32Magic = CRASH_MAGIC;
+    }
+
+    g_sCrashRecord.ui32Check = CrashCheck();
+}
+
+//*****************************************************************************
+//
+// Returns the last crash recorded and the number of crashes since the record
+// was last found invalid, normally since power on.  *pbNew is set if the
+// crash caused the last reset.  Returns false if no crash is recorded.
+//
+//*****************************************************************************
+bool
+CrashGet(tCrash *psCrash, uint32_t *pui32Count, bool *pbNew)
+{
+    *psCrash = g_sCrash;
+    *pui32Count = g_ui32Count;
+    *pbNew = g_bNew;
+
+    return(g_ui32Count != 0);
+}
+
+//*****************************************************************************
+//
+// Returns the cause of the last reset, as SYSCTL_CAUSE_* flags.
+//
+//*****************************************************************************
+uint32_t
+CrashResetCauseGet(void)
+{
+    return(g_ui32ResetCause);
+}
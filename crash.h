@@ -0,0 +1,135 @@
+//*****************************************************************************
+//
+// crash.h - Records the cause of a crash across the reset that follows it.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __CRASH_H__
+#define __CRASH_H__
+
+//*****************************************************************************
+//
+// The causes of a crash.
+//
+//*****************************************************************************
+#define CRASH_CAUSE_NONE        0
+#define CRASH_CAUSE_FAULT       1
+#define CRASH_CAUSE_STACK       2
+
+//*****************************************************************************
+//
+// Flags of a crash record.
+//
+//*****************************************************************************
+#define CRASH_FLAG_FRAME        0x00000001  // pui32Frame holds the registers
+
+//*****************************************************************************
+//
+// The number of the most recent trace events kept with a crash.
+//
+//*****************************************************************************
+#define CRASH_TRACE_EVENTS      16
+
+//*****************************************************************************
+//
+// The registers saved by the processor on entry to an exception, in the order
+// they are stacked.
+//
+//*****************************************************************************
+#define CRASH_REG_R0            0
+#define CRASH_REG_R1            1
+#define CRASH_REG_R2            2
+#define CRASH_REG_R3            3
+#define CRASH_REG_R12           4
+#define CRASH_REG_LR            5
+#define CRASH_REG_PC            6
+#define CRASH_REG_XPSR          7
+#define CRASH_NUM_REGS          8
+
+//*****************************************************************************
+//
+// The record of a crash.  The fault status registers are those of the System
+// Control Block; they are 0 for a stack overflow, which the kernel detects
+// itself.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // One of CRASH_CAUSE_* and CRASH_FLAG_* flags.
+    //
+    uint32_t ui32Cause;
+    uint32_t ui32Flags;
+
+    //
+    // The time of the crash, in milliseconds since boot.
+    //
+    uint32_t ui32Uptime;
+
+    //
+    // The name of the task that was running, or that overflowed its stack.
+    //
+    char pcTask[configMAX_TASK_NAME_LEN];
+
+    //
+    // The registers stacked on entry to the fault handler, indexed by
+    // CRASH_REG_*, the stack pointer they were stacked on and the exception
+    // return value the handler was entered with.
+    //
+    uint32_t pui32Frame[CRASH_NUM_REGS];
+    uint32_t ui32SP;
+    uint32_t ui32ExcReturn;
+
+    //
+    // The configurable and hard fault status registers, and the memory
+    // management and bus fault addresses.
+    //
+    uint32_t ui32CFSR;
+    uint32_t ui32HFSR;
+    uint32_t ui32MMFAR;
+    uint32_t ui32BFAR;
+
+    //
+    // The free space of the FreeRTOS heap, in bytes.
+    //
+    uint32_t ui32HeapFree;
+
+    //
+    // The last events of the trace before the crash, oldest first.
+    //
+    uint32_t ui32TraceCount;
+    tTraceEvent psTrace[CRASH_TRACE_EVENTS];
+}
+tCrash;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void CrashInit(void);
+extern bool CrashGet(tCrash *psCrash, uint32_t *pui32Count, bool *pbNew);
+extern uint32_t CrashResetCauseGet(void);
+extern void CrashStackOverflow(const char *pcTask);
+extern void CrashFaultISR(void);
+extern void CrashFaultCapture(uint32_t *pui32SP, uint32_t ui32ExcReturn);
+
+#endif // __CRASH_H__
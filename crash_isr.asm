@@ -0,0 +1,48 @@
+;******************************************************************************
+;
+; crash_isr.asm - The hard fault handler, which hands the saved registers to
+;                 CrashFaultCapture() in crash.c.
+;
+; Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+; Software License Agreement
+;
+; Texas Instruments (TI) is supplying this software for use solely and
+; exclusively on TI's microcontroller products. The software is owned by
+; TI and/or its suppliers, and is protected under applicable copyright
+; laws. You may not combine this software with "viral" open-source
+; software in order to form a larger program.
+;
+; THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+; NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+; NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+; A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+; CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+; DAMAGES, FOR ANY REASON WHATSOEVER.
+;
+; This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+;
+;******************************************************************************
+
+	.thumb
+	.text
+
+	.global CrashFaultISR
+	.global CrashFaultCapture
+
+;******************************************************************************
+;
+; The processor stacks r0-r3, r12, lr, pc and xpsr on the process stack if a
+; task was running and on the main stack otherwise, as bit 2 of the exception
+; return value in lr tells.  This must be written in assembly so that the
+; stack pointer and lr are read before any code of the handler changes them.
+;
+;******************************************************************************
+CrashFaultISR:
+	tst r14, #4
+	ite EQ
+	mrseq r0, msp
+	mrsne r0, psp
+	mov r1, r14
+	b CrashFaultCapture
+
+	.end
@@ -0,0 +1,469 @@
+//*****************************************************************************
+//
+// glyphcache.c - A cache of pre-rendered string glyphs for the Kentec
+//                K350QVG-V2-F display.
+//
+// Copyright (c) 2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.0.1.11577 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "grlib/grlib.h"
+#include "drivers/kentec320x240x16_ssd2119.h"
+#include "drivers/glyphcache.h"
+
+//*****************************************************************************
+//
+//! \addtogroup glyphcache_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Strings drawn with GlyphCacheStringDraw() are drawn a character at a time
+// from a cache of glyphs that have already been rendered, in their colors,
+// into the display's native 16-bit format.  A cached glyph is sent to the
+// display as a single block, instead of being decoded from the font and
+// written pixel by pixel by grlib.  Glyphs are rendered into the cache by
+// grlib itself, through a display driver that draws into the cache entry, so
+// they are identical to those drawn by GrStringDraw().
+//
+// The cache is not protected against concurrent use; strings must be drawn
+// from one task at a time, as with the rest of grlib.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The number of glyphs held in the cache.  When it is full, the glyph that
+// was used least recently is replaced.
+//
+//*****************************************************************************
+#ifndef GLYPH_CACHE_ENTRIES
+#define GLYPH_CACHE_ENTRIES     24
+#endif
+
+//*****************************************************************************
+//
+// The largest glyph that can be cached, in pixels.  Larger glyphs are drawn
+// by grlib as usual.
+//
+//*****************************************************************************
+#ifndef GLYPH_CACHE_MAX_PIXELS
+#define GLYPH_CACHE_MAX_PIXELS  320
+#endif
+#define GLYPH_CACHE_MAX_WIDTH   32
+#define GLYPH_CACHE_MAX_HEIGHT  32
+
+//*****************************************************************************
+//
+// A cached glyph.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The font, character and (display-specific) colors the glyph was
+    // rendered with.
+    //
+    const tFont *psFont;
+    uint32_t ui32Foreground;
+    uint32_t ui32Background;
+    uint8_t ui8Char;
+
+    //
+    // The size of the glyph.
+    //
+    uint8_t ui8Width;
+    uint8_t ui8Height;
+
+    //
+    // The value of g_ui32GlyphUse when the glyph was last drawn, or 0 if the
+    // entry is not in use.
+    //
+    uint32_t ui32LastUse;
+
+    //
+    // The pixels of the glyph, row by row, each as a big-endian 16-bit
+    // color.
+    //
+    uint8_t pui8Pixels[GLYPH_CACHE_MAX_PIXELS * 2];
+}
+tGlyphCacheEntry;
+
+//*****************************************************************************
+//
+// The cache, a counter used to find the least recently used entry, and the
+// hit and miss counts.
+//
+//*****************************************************************************
+static tGlyphCacheEntry g_psGlyphCache[GLYPH_CACHE_ENTRIES];
+static uint32_t g_ui32GlyphUse;
+static uint32_t g_ui32GlyphHits;
+static uint32_t g_ui32GlyphMisses;
+
+//*****************************************************************************
+//
+// The entry being rendered by the capture display.
+//
+//*****************************************************************************
+static tGlyphCacheEntry *g_psCapture;
+
+//*****************************************************************************
+//
+// Writes a pixel into the entry being rendered, ignoring pixels outside it.
+//
+//*****************************************************************************
+static void
+CapturePixelDraw(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                 uint32_t ui32Value)
+{
+    uint8_t *pui8Pixel;
+
+    if((i32X < 0) || (i32X >= g_psCapture->ui8Width) ||
+       (i32Y < 0) || (i32Y >= g_psCapture->ui8Height))
+    {
+        return;
+    }
+
+    pui8Pixel = &g_psCapture->pui8Pixels[((i32Y * g_psCapture->ui8Width) +
+                                          i32X) * 2];
+    pui8Pixel[0] = ui32Value >> 8;
+    pui8Pixel[1] = ui32Value & 0xff;
+}
+
+//*****************************************************************************
+//
+// Translates a 24-bit RGB color in the same way as the Kentec display.
+//
+//*****************************************************************************
+static uint32_t
+CaptureColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+    return(g_sKentec320x240x16_SSD2119.pfnColorTranslate(
+               g_sKentec320x240x16_SSD2119.pvDisplayData, ui32Value));
+}
+
+//*****************************************************************************
+//
+// Draws a horizontal sequence of pixels into the entry being rendered.
+//
+//*****************************************************************************
+static void
+CapturePixelDrawMultiple(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                         int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+                         const uint8_t *pui8Data, const uint8_t *pui8Palette)
+{
+    uint32_t ui32Color;
+
+    i32BPP &= ~GRLIB_DRIVER_FLAG_NEW_IMAGE;
+    for(; i32Count > 0; i32Count--, i32X++)
+    {
+        if(i32BPP == 1)
+        {
+            //
+            // The palette holds pre-translated colors.
+            //
+            ui32Color = ((uint32_t *)pui8Palette)[(*pui8Data >>
+                                                   (7 - i32X0)) & 1];
+            if(++i32X0 == 8)
+            {
+                i32X0 = 0;
+                pui8Data++;
+            }
+        }
+        else
+        {
+            if(i32BPP == 4)
+            {
+                ui32Color = ((i32X0++ & 1) ? (*pui8Data++ & 15) :
+                             (*pui8Data >> 4)) * 3;
+            }
+            else
+            {
+                ui32Color = *pui8Data++ * 3;
+            }
+            ui32Color = CaptureColorTranslate(pvDisplayData,
+                                              (*(uint32_t *)(pui8Palette +
+                                                             ui32Color) &
+                                               0x00ffffff));
+        }
+        CapturePixelDraw(pvDisplayData, i32X, i32Y, ui32Color);
+    }
+}
+
+//*****************************************************************************
+//
+// Draws a horizontal line into the entry being rendered.
+//
+//*****************************************************************************
+static void
+CaptureLineDrawH(void *pvDisplayData, int32_t i32X1, int32_t i32X2,
+                 int32_t i32Y, uint32_t ui32Value)
+{
+    for(; i32X1 <= i32X2; i32X1++)
+    {
+        CapturePixelDraw(pvDisplayData, i32X1, i32Y, ui32Value);
+    }
+}
+
+//*****************************************************************************
+//
+// Draws a vertical line into the entry being rendered.
+//
+//*****************************************************************************
+static void
+CaptureLineDrawV(void *pvDisplayData, int32_t i32X, int32_t i32Y1,
+                 int32_t i32Y2, uint32_t ui32Value)
+{
+    for(; i32Y1 <= i32Y2; i32Y1++)
+    {
+        CapturePixelDraw(pvDisplayData, i32X, i32Y1, ui32Value);
+    }
+}
+
+//*****************************************************************************
+//
+// Fills a rectangle in the entry being rendered.
+//
+//*****************************************************************************
+static void
+CaptureRectFill(void *pvDisplayData, const tRectangle *psRect,
+                uint32_t ui32Value)
+{
+    int32_t i32Y;
+
+    for(i32Y = psRect->i16YMin; i32Y <= psRect->i16YMax; i32Y++)
+    {
+        CaptureLineDrawH(pvDisplayData, psRect->i16XMin, psRect->i16XMax,
+                         i32Y, ui32Value);
+    }
+}
+
+//*****************************************************************************
+//
+// There is nothing to flush when rendering into the cache.
+//
+//*****************************************************************************
+static void
+CaptureFlush(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+// The display used to render glyphs into the cache.
+//
+//*****************************************************************************
+static const tDisplay g_sCaptureDisplay =
+{
+    sizeof(tDisplay),
+    0,
+    GLYPH_CACHE_MAX_WIDTH,
+    GLYPH_CACHE_MAX_HEIGHT,
+    CapturePixelDraw,
+    CapturePixelDrawMultiple,
+    CaptureLineDrawH,
+    CaptureLineDrawV,
+    CaptureRectFill,
+    CaptureColorTranslate,
+    CaptureFlush
+};
+
+//*****************************************************************************
+//
+// Returns the cached glyph for a character drawn with the given context,
+// rendering it into the cache if necessary, or NULL if it cannot be cached.
+//
+//*****************************************************************************
+static const tGlyphCacheEntry *
+GlyphGet(const tContext *psContext, const char *pcChar)
+{
+    tGlyphCacheEntry *psEntry;
+    tContext sCapture;
+    uint32_t ui32Idx;
+    int32_t i32Width, i32Height;
+
+    //
+    // Only single-byte characters are cached.
+    //
+    if(*pcChar & 0x80)
+    {
+        return(0);
+    }
+
+    //
+    // Look for the glyph in the cache, noting the least recently used entry
+    // on the way.
+    //
+    psEntry = &g_psGlyphCache[0];
+    for(ui32Idx = 0; ui32Idx < GLYPH_CACHE_ENTRIES; ui32Idx++)
+    {
+        if(g_psGlyphCache[ui32Idx].ui32LastUse &&
+           (g_psGlyphCache[ui32Idx].ui8Char == (uint8_t)*pcChar) &&
+           (g_psGlyphCache[ui32Idx].psFont == psContext->psFont) &&
+           (g_psGlyphCache[ui32Idx].ui32Foreground ==
+            psContext->ui32Foreground) &&
+           (g_psGlyphCache[ui32Idx].ui32Background ==
+            psContext->ui32Background))
+        {
+            g_ui32GlyphHits++;
+            g_psGlyphCache[ui32Idx].ui32LastUse = ++g_ui32GlyphUse;
+            return(&g_psGlyphCache[ui32Idx]);
+        }
+        if(g_psGlyphCache[ui32Idx].ui32LastUse < psEntry->ui32LastUse)
+        {
+            psEntry = &g_psGlyphCache[ui32Idx];
+        }
+    }
+
+    g_ui32GlyphMisses++;
+
+    //
+    // Give up if the glyph is too large for a cache entry.
+    //
+    i32Width = GrStringWidthGet(psContext, pcChar, 1);
+    i32Height = GrStringHeightGet(psContext);
+    if((i32Width <= 0) || (i32Width > GLYPH_CACHE_MAX_WIDTH) ||
+       (i32Height <= 0) || (i32Height > GLYPH_CACHE_MAX_HEIGHT) ||
+       ((i32Width * i32Height) > GLYPH_CACHE_MAX_PIXELS))
+    {
+        return(0);
+    }
+
+    //
+    // Replace the least recently used entry, starting from the background
+    // color in case the glyph does not cover its whole cell.
+    //
+    psEntry->psFont = psContext->psFont;
+    psEntry->ui32Foreground = psContext->ui32Foreground;
+    psEntry->ui32Background = psContext->ui32Background;
+    psEntry->ui8Char = *pcChar;
+    psEntry->ui8Width = i32Width;
+    psEntry->ui8Height = i32Height;
+    psEntry->ui32LastUse = ++g_ui32GlyphUse;
+    g_psCapture = psEntry;
+    for(ui32Idx = 0; ui32Idx < (uint32_t)(i32Width * i32Height); ui32Idx++)
+    {
+        CapturePixelDraw(0, ui32Idx % i32Width, ui32Idx / i32Width,
+                         psContext->ui32Background);
+    }
+
+    //
+    // Have grlib render the glyph into the entry, using a copy of the
+    // caller's context so that the font and string renderer are the same.
+    //
+    sCapture = *psContext;
+    sCapture.psDisplay = &g_sCaptureDisplay;
+    sCapture.sClipRegion.i16XMin = 0;
+    sCapture.sClipRegion.i16YMin = 0;
+    sCapture.sClipRegion.i16XMax = i32Width - 1;
+    sCapture.sClipRegion.i16YMax = i32Height - 1;
+    GrStringDraw(&sCapture, pcChar, 1, 0, 0, true);
+
+    return(psEntry);
+}
+
+//*****************************************************************************
+//
+//! Draws a string using the glyph cache.
+//!
+//! \param psContext is a pointer to the drawing context to use.
+//! \param pcString is a pointer to the string to be drawn.
+//! \param i32Length is the number of characters from the string that should
+//! be drawn on the screen, or -1 to draw the whole string.
+//! \param i32X is the X coordinate of the upper left corner of the string.
+//! \param i32Y is the Y coordinate of the upper left corner of the string.
+//!
+//! This function draws a string with an opaque background, exactly as
+//! GrStringDraw() would, but sends each character to the display as a single
+//! block taken from the glyph cache.  Strings that are not entirely within
+//! the clipping region, or drawn on a display other than the Kentec display,
+//! are passed on to GrStringDraw().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GlyphCacheStringDraw(tContext *psContext, const char *pcString,
+                     int32_t i32Length, int32_t i32X, int32_t i32Y)
+{
+    const tGlyphCacheEntry *psEntry;
+
+    //
+    // Let grlib draw strings that it would have to clip.
+    //
+    if((psContext->psDisplay != &g_sKentec320x240x16_SSD2119) ||
+       (i32X < psContext->sClipRegion.i16XMin) ||
+       (i32Y < psContext->sClipRegion.i16YMin) ||
+       ((i32X + GrStringWidthGet(psContext, pcString, i32Length) - 1) >
+        psContext->sClipRegion.i16XMax) ||
+       ((i32Y + GrStringHeightGet(psContext) - 1) >
+        psContext->sClipRegion.i16YMax))
+    {
+        GrStringDraw(psContext, pcString, i32Length, i32X, i32Y, true);
+        return;
+    }
+
+    //
+    // Draw the string a character at a time.
+    //
+    for(; i32Length && *pcString; i32Length--, pcString++)
+    {
+        psEntry = GlyphGet(psContext, pcString);
+        if(psEntry)
+        {
+            Kentec320x240x16_SSD2119BlockDraw(i32X, i32Y, psEntry->ui8Width,
+                                              psEntry->ui8Height,
+                                              psEntry->pui8Pixels);
+            i32X += psEntry->ui8Width;
+        }
+        else
+        {
+            GrStringDraw(psContext, pcString, 1, i32X, i32Y, true);
+            i32X += GrStringWidthGet(psContext, pcString, 1);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Gets the glyph cache statistics.
+//!
+//! \param pui32Hits is a pointer to the number of glyphs found in the cache.
+//! \param pui32Misses is a pointer to the number of glyphs that were not.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GlyphCacheStatsGet(uint32_t *pui32Hits, uint32_t *pui32Misses)
+{
+    *pui32Hits = g_ui32GlyphHits;
+    *pui32Misses = g_ui32GlyphMisses;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,38 @@
+//*****************************************************************************
+//
+// glyphcache.h - Prototypes for the cache of pre-rendered string glyphs.
+//
+// Copyright (c) 2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.0.1.11577 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __GLYPHCACHE_H__
+#define __GLYPHCACHE_H__
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void GlyphCacheStringDraw(tContext *psContext, const char *pcString,
+                                 int32_t i32Length, int32_t i32X,
+                                 int32_t i32Y);
+extern void GlyphCacheStatsGet(uint32_t *pui32Hits, uint32_t *pui32Misses);
+
+#endif // __GLYPHCACHE_H__
@@ -39,6 +39,13 @@
 #include "driverlib/lcd.h"
 #include "grlib/grlib.h"
 #include "drivers/kentec320x240x16_ssd2119.h"
+#if KENTEC_USE_DMA && !defined(KENTEC_DMA_SIM)
+#include "inc/hw_lcd.h"
+#include "driverlib/udma.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
 
 //*****************************************************************************
 //
@@ -279,6 +286,109 @@
                                  (((c) & 0x0000fc00) >> 5) |                  \
                                  (((c) & 0x000000f8) >> 3))
 
+//*****************************************************************************
+//
+// Pixel data can be streamed to the display by the uDMA controller instead of
+// the CPU.  The LIDD interface has no DMA request line of its own, so the
+// uDMA software channel is used in auto mode: each write to the LIDD data
+// register stalls the bus until the interface is ready for the next byte,
+// which paces the transfer exactly as it paces WriteData().  Pixels are
+// staged as big-endian 16-bit values in a small buffer; runs longer than the
+// buffer are sent as a sequence of transfers that are chained from the uDMA
+// interrupt, and fills simply send the same buffer repeatedly.  A sequence of
+// equally spaced blocks, such as the rows of a rectangle in the frame
+// buffer, can be sent in the same way.  Runs shorter
+// than KENTEC_DMA_MIN_PIXELS are cheaper to write directly.
+//
+// When KENTEC_DMA_SIM is defined (for example in a host build), the transfers
+// are performed by the CPU instead, and the statistics returned by
+// Kentec320x240x16_SSD2119DMAStatsGet() also count the bytes written by the
+// CPU so that the two paths can be compared.
+//
+// Define KENTEC_USE_DMA to 0 to draw with the CPU only.
+//
+//*****************************************************************************
+#if KENTEC_USE_DMA
+
+//*****************************************************************************
+//
+// The shortest run of pixels that is sent using the uDMA controller.
+//
+//*****************************************************************************
+#ifndef KENTEC_DMA_MIN_PIXELS
+#define KENTEC_DMA_MIN_PIXELS   32
+#endif
+
+//*****************************************************************************
+//
+// The number of pixels in each of the two staging buffers.  A transfer can be
+// at most 1024 bytes long.
+//
+//*****************************************************************************
+#define KENTEC_DMA_BUF_PIXELS   256
+
+//*****************************************************************************
+//
+// The staging buffers.  While one is being sent, the next run of pixels is
+// converted into the other.
+//
+//*****************************************************************************
+static uint8_t g_ppui8DMABuf[2][KENTEC_DMA_BUF_PIXELS * 2];
+
+//*****************************************************************************
+//
+// The state of the transfer in progress.
+//
+//*****************************************************************************
+static const uint8_t *g_pui8DMASrc;
+static uint32_t g_ui32DMABytes;
+static int32_t g_i32DMAStride;
+static volatile uint32_t g_ui32DMARepeat;
+static volatile bool g_bDMABusy;
+
+//*****************************************************************************
+//
+// The transfer statistics.
+//
+//*****************************************************************************
+static tKentecDMAStats g_sDMAStats;
+
+#ifdef KENTEC_DMA_SIM
+#define CPU_BYTES_ADD(n)        g_sDMAStats.ui32CPUBytes += (n)
+#else
+#define CPU_BYTES_ADD(n)
+
+//*****************************************************************************
+//
+// The uDMA control table.  Only the primary entry of the software channel is
+// used, but the table must be aligned on a 1024-byte boundary.
+//
+//*****************************************************************************
+#if defined(ewarm)
+#pragma data_alignment=1024
+static tDMAControlTable g_psDMAControlTable[32];
+#elif defined(ccs)
+#pragma DATA_ALIGN(g_psDMAControlTable, 1024)
+static tDMAControlTable g_psDMAControlTable[32];
+#else
+static tDMAControlTable g_psDMAControlTable[32] __attribute__ ((aligned(1024)));
+#endif
+
+//*****************************************************************************
+//
+// The semaphore given by the uDMA interrupt when a run has been sent.  It is
+// created by the first transfer that is started once the scheduler is
+// running, so that drawing done from main() makes no FreeRTOS calls (the first
+// one masks the uDMA interrupt until the scheduler starts).
+//
+//*****************************************************************************
+static xSemaphoreHandle g_sDMADone;
+#endif
+
+#else
+#define CPU_BYTES_ADD(n)
+#endif
+
 //*****************************************************************************
 //
 // Writes a data word to the SSD2119.
@@ -287,6 +397,8 @@
 static inline void
 WriteData(uint16_t ui16Data)
 {
+    CPU_BYTES_ADD(2);
+
     //
     // Split the write into two bytes and pass them to the LCD controller.
     //
@@ -310,147 +422,599 @@ WriteCommand(uint8_t ui8Data)
 
 //*****************************************************************************
 //
-//! Draws a pixel on the screen.
-//!
-//! \param pvDisplayData is a pointer to the driver-specific data for this
-//! display driver.
-//! \param i32X is the X coordinate of the pixel.
-//! \param i32Y is the Y coordinate of the pixel.
-//! \param ui32Value is the color of the pixel.
-//!
-//! This function sets the given pixel to a particular color.  The coordinates
-//! of the pixel are assumed to be within the extents of the display.
-//!
-//! \return None.
+// Returns the display color of the next pixel of a run of palettized pixel
+// data, as passed to PixelDrawMultiple(), and advances past it.  The data
+// pointer and sub-pixel offset are updated in place.
 //
 //*****************************************************************************
-static void
-Kentec320x240x16_SSD2119PixelDraw(void *pvDisplayData, int32_t i32X,
-                                  int32_t i32Y, uint32_t ui32Value)
+static inline uint32_t
+PaletteColorNext(const uint8_t **ppui8Data, int32_t *pi32X0, int32_t i32BPP,
+                 const uint8_t *pui8Palette)
 {
+    uint32_t ui32Byte;
+
+    switch(i32BPP)
+    {
+        //
+        // The palette holds pre-translated colors.
+        //
+        case 1:
+        {
+            ui32Byte = ((uint32_t *)pui8Palette)[(**ppui8Data >>
+                                                  (7 - *pi32X0)) & 1];
+            if(++*pi32X0 == 8)
+            {
+                *pi32X0 = 0;
+                (*ppui8Data)++;
+            }
+            return(ui32Byte);
+        }
+
+        //
+        // The upper nibble holds the left-most pixel.
+        //
+        case 4:
+        {
+            if(*pi32X0 & 1)
+            {
+                ui32Byte = (*(*ppui8Data)++ & 15) * 3;
+            }
+            else
+            {
+                ui32Byte = (**ppui8Data >> 4) * 3;
+            }
+            (*pi32X0)++;
+            break;
+        }
+
+        default:
+        {
+            ui32Byte = *(*ppui8Data)++ * 3;
+            break;
+        }
+    }
+
     //
-    // Set the X address of the display cursor.
+    // Translate the palette entry.
     //
-    WriteCommand(SSD2119_X_RAM_ADDR_REG);
-    WriteData(MAPPED_X(i32X, i32Y));
+    ui32Byte = *(uint32_t *)(pui8Palette + ui32Byte) & 0x00ffffff;
+    return(DPYCOLORTRANSLATE(ui32Byte));
+}
+
+#if KENTEC_USE_DMA
+//*****************************************************************************
+//
+// Sends the current staging buffer to the LIDD data register.
+//
+//*****************************************************************************
+static void
+DMABufferSend(void)
+{
+    g_sDMAStats.ui32Transfers++;
+    g_sDMAStats.ui32DMABytes += g_ui32DMABytes;
+
+#ifdef KENTEC_DMA_SIM
+    {
+        uint32_t ui32Idx;
+
+        for(ui32Idx = 0; ui32Idx < g_ui32DMABytes; ui32Idx++)
+        {
+            LCDIDDDataWrite(LCD0_BASE, 0, g_pui8DMASrc[ui32Idx]);
+        }
+    }
+#else
+    uDMAChannelTransferSet(UDMA_CHANNEL_SW | UDMA_PRI_SELECT, UDMA_MODE_AUTO,
+                           (void *)g_pui8DMASrc,
+                           (void *)(LCD0_BASE + LCD_O_LIDDCS0DATA),
+                           g_ui32DMABytes);
+    uDMAChannelEnable(UDMA_CHANNEL_SW);
+    uDMAChannelRequest(UDMA_CHANNEL_SW);
+#endif
+}
 
+//*****************************************************************************
+//
+// Waits for the transfer in progress, if any, to complete.
+//
+//*****************************************************************************
+static void
+DMAWait(void)
+{
+#ifndef KENTEC_DMA_SIM
     //
-    // Set the Y address of the display cursor.
+    // Block on the completion semaphore if called from a task that can
+    // block.  From the idle task the busy flag is polled instead.  Transfers
+    // started before the scheduler have already completed in DMAStart().
     //
-    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
-    WriteData(MAPPED_Y(i32X, i32Y));
+    if(g_bDMABusy &&
+       (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) &&
+       (xTaskGetCurrentTaskHandle() != xTaskGetIdleTaskHandle()))
+    {
+        xSemaphoreTake(g_sDMADone, portMAX_DELAY);
+    }
+    while(g_bDMABusy)
+    {
+    }
 
     //
-    // Write the pixel value.
+    // Discard a completion that was polled rather than waited for.
     //
-    WriteCommand(SSD2119_RAM_DATA_REG);
-    WriteData(ui32Value);
+    if(g_sDMADone)
+    {
+        xSemaphoreTake(g_sDMADone, 0);
+    }
+#endif
 }
 
+#ifndef KENTEC_DMA_SIM
 //*****************************************************************************
 //
-//! Draws a horizontal sequence of pixels on the screen.
-//!
-//! \param pvDisplayData is a pointer to the driver-specific data for this
-//! display driver.
-//! \param i32X is the X coordinate of the first pixel.
-//! \param i32Y is the Y coordinate of the first pixel.
-//! \param i32X0 is sub-pixel offset within the pixel data, which is valid for
-//! 1 or 4 bit per pixel formats.
-//! \param i32Count is the number of pixels to draw.
-//! \param i32BPP is the number of bits per pixel; must be 1, 4, or 8.
-//! \param pui8Data is a pointer to the pixel data.  For 1 and 4 bit per pixel
-//! formats, the most significant bit(s) represent the left-most pixel.
-//! \param pui8Palette is a pointer to the palette used to draw the pixels.
-//!
-//! This function draws a horizontal sequence of pixels on the screen, using
-//! the supplied palette.  For 1 bit per pixel format, the palette contains
-//! pre-translated colors; for 4 and 8 bit per pixel formats, the palette
-//! contains 24-bit RGB values that must be translated before being written to
-//! the display.
-//!
-//! \return None.
+// Sends ui32Repeat blocks starting with the current one without using the
+// uDMA interrupt, returning once the last of them has been sent.
 //
 //*****************************************************************************
 static void
-Kentec320x240x16_SSD2119PixelDrawMultiple(void *pvDisplayData, int32_t i32X,
-                                          int32_t i32Y, int32_t i32X0,
-                                          int32_t i32Count, int32_t i32BPP,
-                                          const uint8_t *pui8Data,
-                                          const uint8_t *pui8Palette)
+DMAPoll(uint32_t ui32Repeat)
 {
-    uint32_t ui32Byte;
-
     //
-    // Set the cursor increment to left to right, followed by top to bottom.
+    // Keep the handler from chaining the blocks as well, should the
+    // interrupt not be masked.
     //
-    WriteCommand(SSD2119_ENTRY_MODE_REG);
-    WriteData(MAKE_ENTRY_MODE(HORIZ_DIRECTION));
+    IntDisable(INT_UDMA);
+
+    while(ui32Repeat--)
+    {
+        DMABufferSend();
+        while(uDMAChannelModeGet(UDMA_CHANNEL_SW | UDMA_PRI_SELECT) !=
+              UDMA_MODE_STOP)
+        {
+        }
+        g_pui8DMASrc += g_i32DMAStride;
+    }
 
     //
-    // Set the starting X address of the display cursor.
+    // Drop the completions that were polled.
     //
-    WriteCommand(SSD2119_X_RAM_ADDR_REG);
-    WriteData(MAPPED_X(i32X, i32Y));
+    uDMAIntClear(1 << UDMA_CHANNEL_SW);
+    IntPendClear(INT_UDMA);
+    IntEnable(INT_UDMA);
+}
+#endif
+
+//*****************************************************************************
+//
+// Starts sending ui32Repeat blocks of ui32Bytes bytes to the display, the
+// first from pui8Buf and each of the others i32Stride bytes after the one
+// before it.  Any transfer in progress must already have completed.
+//
+//*****************************************************************************
+static void
+DMAStart(const uint8_t *pui8Buf, uint32_t ui32Bytes, uint32_t ui32Repeat,
+         int32_t i32Stride)
+{
+    g_pui8DMASrc = pui8Buf;
+    g_ui32DMABytes = ui32Bytes;
+    g_i32DMAStride = i32Stride;
 
+#ifdef KENTEC_DMA_SIM
+    while(ui32Repeat--)
+    {
+        DMABufferSend();
+        g_pui8DMASrc += i32Stride;
+    }
+#else
     //
-    // Set the Y address of the display cursor.
+    // Until the scheduler is running the first FreeRTOS call made by main()
+    // leaves the uDMA interrupt masked, so the transfer is polled to
+    // completion here instead.
     //
-    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
-    WriteData(MAPPED_Y(i32X, i32Y));
+    if(xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        DMAPoll(ui32Repeat);
+        return;
+    }
+
+    if(!g_sDMADone)
+    {
+        vSemaphoreCreateBinary(g_sDMADone);
+        if(!g_sDMADone)
+        {
+            DMAPoll(ui32Repeat);
+            return;
+        }
+        xSemaphoreTake(g_sDMADone, 0);
+    }
+
+    g_ui32DMARepeat = ui32Repeat - 1;
+    g_bDMABusy = true;
+    DMABufferSend();
+#endif
+}
+
+//*****************************************************************************
+//
+// Writes i32Count pixels of the given color to the display.
+//
+//*****************************************************************************
+static void
+DMAFill(uint32_t ui32Value, int32_t i32Count)
+{
+    uint8_t *pui8Buf;
+    int32_t i32Idx, i32Pixels;
 
     //
-    // Write the data RAM write command.
+    // Fill as much of the staging buffer as is needed with the color.
     //
-    WriteCommand(SSD2119_RAM_DATA_REG);
+    pui8Buf = g_ppui8DMABuf[0];
+    i32Pixels = ((i32Count < KENTEC_DMA_BUF_PIXELS) ? i32Count :
+                 KENTEC_DMA_BUF_PIXELS);
+    for(i32Idx = 0; i32Idx < i32Pixels; i32Idx++)
+    {
+        pui8Buf[i32Idx * 2] = ui32Value >> 8;
+        pui8Buf[(i32Idx * 2) + 1] = ui32Value & 0xff;
+    }
 
     //
-    // Determine how to interpret the pixel data based on the number of bits
-    // per pixel.
+    // Send the whole buffers, then whatever is left over.
     //
-    switch(i32BPP & ~GRLIB_DRIVER_FLAG_NEW_IMAGE)
+    DMAStart(pui8Buf, i32Pixels * 2, i32Count / i32Pixels, 0);
+    i32Count %= i32Pixels;
+    if(i32Count)
+    {
+        DMAWait();
+        DMAStart(pui8Buf, i32Count * 2, 1, 0);
+    }
+    DMAWait();
+}
+
+#ifndef KENTEC_FRAMEBUFFER
+//*****************************************************************************
+//
+// Converts a run of palettized pixels into the staging buffers and writes it
+// to the display.  The arguments are those of PixelDrawMultiple().
+//
+//*****************************************************************************
+static void
+DMAPixelRun(int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+            const uint8_t *pui8Data, const uint8_t *pui8Palette)
+{
+    uint32_t ui32Color, ui32Buf;
+    uint8_t *pui8Buf;
+    int32_t i32Idx;
+
+    ui32Buf = 0;
+    while(i32Count)
     {
         //
-        // The pixel data is in 1 bit per pixel format.
+        // Convert as many pixels as fit into the free staging buffer.  The
+        // other buffer may still be being sent.
         //
-        case 1:
+        pui8Buf = g_ppui8DMABuf[ui32Buf];
+        for(i32Idx = 0; (i32Idx < KENTEC_DMA_BUF_PIXELS) && i32Count;
+            i32Idx++, i32Count--)
         {
-            //
-            // Loop while there are more pixels to draw.
-            //
-            while(i32Count)
-            {
-                //
-                // Get the next byte of image data.
-                //
-                ui32Byte = *pui8Data++;
-
-                //
-                // Loop through the pixels in this byte of image data.
-                //
-                for(; (i32X0 < 8) && i32Count; i32X0++, i32Count--)
-                {
-                    //
-                    // Draw this pixel in the appropriate color.
-                    //
-                    WriteData(((uint32_t *)pui8Palette)[(ui32Byte >>
-                                                         (7 - i32X0)) & 1]);
-                }
-
-                //
-                // Start at the beginning of the next byte of image data.
-                //
-                i32X0 = 0;
-            }
-
-            //
-            // The image data has been drawn.
-            //
-            break;
+            ui32Color = PaletteColorNext(&pui8Data, &i32X0, i32BPP,
+                                         pui8Palette);
+            pui8Buf[i32Idx * 2] = ui32Color >> 8;
+            pui8Buf[(i32Idx * 2) + 1] = ui32Color & 0xff;
         }
 
         //
-        // The pixel data is in 4 bit per pixel format.
+        // Send this buffer once the previous one has gone, and convert the
+        // next run into the other buffer while it is sent.
+        //
+        DMAWait();
+        DMAStart(pui8Buf, i32Idx * 2, 1, 0);
+        ui32Buf ^= 1;
+    }
+    DMAWait();
+}
+#endif
+
+#ifndef KENTEC_DMA_SIM
+//*****************************************************************************
+//
+//! Handles the uDMA software channel interrupt.
+//!
+//! This function must be installed in the vector table as the handler for the
+//! uDMA software transfer interrupt.  It starts the next repeat of a fill, or
+//! signals the drawing task that the run has been sent.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Kentec320x240x16_SSD2119DMAIntHandler(void)
+{
+    portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+    uDMAIntClear(1 << UDMA_CHANNEL_SW);
+
+    //
+    // Ignore the interrupt if the transfer has not actually finished.
+    //
+    if(!g_bDMABusy ||
+       (uDMAChannelModeGet(UDMA_CHANNEL_SW | UDMA_PRI_SELECT) !=
+        UDMA_MODE_STOP))
+    {
+        return;
+    }
+
+    if(g_ui32DMARepeat)
+    {
+        g_ui32DMARepeat--;
+        g_pui8DMASrc += g_i32DMAStride;
+        DMABufferSend();
+    }
+    else
+    {
+        g_bDMABusy = false;
+        xSemaphoreGiveFromISR(g_sDMADone, &xHigherPriorityTaskWoken);
+        portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+//! Gets the uDMA transfer statistics.
+//!
+//! \param psStats is a pointer to the structure to fill in.
+//!
+//! This function returns the number of transfers and bytes sent to the
+//! display by the uDMA controller since the driver was initialized.  When
+//! the driver is built with KENTEC_DMA_SIM, the number of bytes written by
+//! the CPU is also counted.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Kentec320x240x16_SSD2119DMAStatsGet(tKentecDMAStats *psStats)
+{
+    *psStats = g_sDMAStats;
+}
+#endif
+
+//*****************************************************************************
+//
+// Restricts drawing to the given rectangle and prepares the SSD2119 to receive
+// its pixels, row by row from the upper left (in application coordinate
+// space).
+//
+//*****************************************************************************
+static void
+WindowSet(const tRectangle *psRect)
+{
+    //
+    // Set the cursor increment to left to right, followed by top to bottom.
+    //
+    WriteCommand(SSD2119_ENTRY_MODE_REG);
+    WriteData(MAKE_ENTRY_MODE(HORIZ_DIRECTION));
+
+    //
+    // Write the X extents of the rectangle.
+    //
+    WriteCommand(SSD2119_H_RAM_START_REG);
+#if (defined PORTRAIT) || (defined LANDSCAPE)
+    WriteData(MAPPED_X(psRect->i16XMax, psRect->i16YMax));
+#else
+    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
+#endif
+
+    WriteCommand(SSD2119_H_RAM_END_REG);
+#if (defined PORTRAIT) || (defined LANDSCAPE)
+    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
+#else
+    WriteData(MAPPED_X(psRect->i16XMax, psRect->i16YMax));
+#endif
+
+    //
+    // Write the Y extents of the rectangle
+    //
+    WriteCommand(SSD2119_V_RAM_POS_REG);
+#if (defined LANDSCAPE_FLIP) || (defined PORTRAIT)
+    WriteData(MAPPED_Y(psRect->i16XMin, psRect->i16YMin) |
+             (MAPPED_Y(psRect->i16XMax, psRect->i16YMax) << 8));
+#else
+    WriteData(MAPPED_Y(psRect->i16XMax, psRect->i16YMax) |
+             (MAPPED_Y(psRect->i16XMin, psRect->i16YMin) << 8));
+#endif
+
+    //
+    // Set the display cursor to the upper left of the rectangle (in
+    // application coordinate space).
+    //
+    WriteCommand(SSD2119_X_RAM_ADDR_REG);
+    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
+    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
+    WriteData(MAPPED_Y(psRect->i16XMin, psRect->i16YMin));
+
+    //
+    // Tell the controller to write data into its RAM.
+    //
+    WriteCommand(SSD2119_RAM_DATA_REG);
+}
+
+//*****************************************************************************
+//
+// Resets the drawing window to the entire screen.
+//
+//*****************************************************************************
+static void
+WindowReset(void)
+{
+    //
+    // Reset the X extents to the entire screen.
+    //
+    WriteCommand(SSD2119_H_RAM_START_REG);
+    WriteData(0x0000);
+    WriteCommand(SSD2119_H_RAM_END_REG);
+    WriteData(0x013f);
+
+    //
+    // Reset the Y extent to the full screen
+    //
+    WriteCommand(SSD2119_V_RAM_POS_REG);
+    WriteData(0xef00);
+}
+
+#ifndef KENTEC_FRAMEBUFFER
+//*****************************************************************************
+//
+//! Draws a pixel on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param i32X is the X coordinate of the pixel.
+//! \param i32Y is the Y coordinate of the pixel.
+//! \param ui32Value is the color of the pixel.
+//!
+//! This function sets the given pixel to a particular color.  The coordinates
+//! of the pixel are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119PixelDraw(void *pvDisplayData, int32_t i32X,
+                                  int32_t i32Y, uint32_t ui32Value)
+{
+    //
+    // Set the X address of the display cursor.
+    //
+    WriteCommand(SSD2119_X_RAM_ADDR_REG);
+    WriteData(MAPPED_X(i32X, i32Y));
+
+    //
+    // Set the Y address of the display cursor.
+    //
+    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
+    WriteData(MAPPED_Y(i32X, i32Y));
+
+    //
+    // Write the pixel value.
+    //
+    WriteCommand(SSD2119_RAM_DATA_REG);
+    WriteData(ui32Value);
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param i32X is the X coordinate of the first pixel.
+//! \param i32Y is the Y coordinate of the first pixel.
+//! \param i32X0 is sub-pixel offset within the pixel data, which is valid for
+//! 1 or 4 bit per pixel formats.
+//! \param i32Count is the number of pixels to draw.
+//! \param i32BPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pui8Data is a pointer to the pixel data.  For 1 and 4 bit per pixel
+//! formats, the most significant bit(s) represent the left-most pixel.
+//! \param pui8Palette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws a horizontal sequence of pixels on the screen, using
+//! the supplied palette.  For 1 bit per pixel format, the palette contains
+//! pre-translated colors; for 4 and 8 bit per pixel formats, the palette
+//! contains 24-bit RGB values that must be translated before being written to
+//! the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119PixelDrawMultiple(void *pvDisplayData, int32_t i32X,
+                                          int32_t i32Y, int32_t i32X0,
+                                          int32_t i32Count, int32_t i32BPP,
+                                          const uint8_t *pui8Data,
+                                          const uint8_t *pui8Palette)
+{
+    uint32_t ui32Byte;
+
+    //
+    // Set the cursor increment to left to right, followed by top to bottom.
+    //
+    WriteCommand(SSD2119_ENTRY_MODE_REG);
+    WriteData(MAKE_ENTRY_MODE(HORIZ_DIRECTION));
+
+    //
+    // Set the starting X address of the display cursor.
+    //
+    WriteCommand(SSD2119_X_RAM_ADDR_REG);
+    WriteData(MAPPED_X(i32X, i32Y));
+
+    //
+    // Set the Y address of the display cursor.
+    //
+    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
+    WriteData(MAPPED_Y(i32X, i32Y));
+
+    //
+    // Write the data RAM write command.
+    //
+    WriteCommand(SSD2119_RAM_DATA_REG);
+
+#if KENTEC_USE_DMA
+    //
+    // Hand long runs to the uDMA controller.
+    //
+    if(i32Count >= KENTEC_DMA_MIN_PIXELS)
+    {
+        DMAPixelRun(i32X0, i32Count, i32BPP & ~GRLIB_DRIVER_FLAG_NEW_IMAGE,
+                    pui8Data, pui8Palette);
+        return;
+    }
+#endif
+
+    //
+    // Determine how to interpret the pixel data based on the number of bits
+    // per pixel.
+    //
+    switch(i32BPP & ~GRLIB_DRIVER_FLAG_NEW_IMAGE)
+    {
+        //
+        // The pixel data is in 1 bit per pixel format.
+        //
+        case 1:
+        {
+            //
+            // Loop while there are more pixels to draw.
+            //
+            while(i32Count)
+            {
+                //
+                // Get the next byte of image data.
+                //
+                ui32Byte = *pui8Data++;
+
+                //
+                // Loop through the pixels in this byte of image data.
+                //
+                for(; (i32X0 < 8) && i32Count; i32X0++, i32Count--)
+                {
+                    //
+                    // Draw this pixel in the appropriate color.
+                    //
+                    WriteData(((uint32_t *)pui8Palette)[(ui32Byte >>
+                                                         (7 - i32X0)) & 1]);
+                }
+
+                //
+                // Start at the beginning of the next byte of image data.
+                //
+                i32X0 = 0;
+            }
+
+            //
+            // The image data has been drawn.
+            //
+            break;
+        }
+
+        //
+        // The pixel data is in 4 bit per pixel format.
         //
         case 4:
         {
@@ -599,6 +1163,17 @@ Kentec320x240x16_SSD2119LineDrawH(void *pvDisplayData, int32_t i32X1,
     //
     WriteCommand(SSD2119_RAM_DATA_REG);
 
+#if KENTEC_USE_DMA
+    //
+    // Hand long lines to the uDMA controller.
+    //
+    if((i32X2 - i32X1 + 1) >= KENTEC_DMA_MIN_PIXELS)
+    {
+        DMAFill(ui32Value, i32X2 - i32X1 + 1);
+        return;
+    }
+#endif
+
     //
     // Loop through the pixels of this horizontal line.
     //
@@ -647,127 +1222,97 @@ Kentec320x240x16_SSD2119LineDrawV(void *pvDisplayData, int32_t i32X,
 
     //
     // Set the starting Y address of the display cursor.
-    //
-    WriteCommand(SSD2119_Y_RAM_ADDR_REG);
-    WriteData(MAPPED_Y(i32X, i32Y1));
-
-    //
-    // Write the data RAM write command.
-    //
-    WriteCommand(SSD2119_RAM_DATA_REG);
-
-    //
-    // Loop through the pixels of this vertical line.
-    //
-    while(i32Y1++ <= i32Y2)
-    {
-        //
-        // Write the pixel value.
-        //
-        WriteData(ui32Value);
-    }
-}
-
-//*****************************************************************************
-//
-//! Fills a rectangle.
-//!
-//! \param pvDisplayData is a pointer to the driver-specific data for this
-//! display driver.
-//! \param psRect is a pointer to the structure describing the rectangle.
-//! \param ui32Value is the color of the rectangle.
-//!
-//! This function fills a rectangle on the display.  The coordinates of the
-//! rectangle are assumed to be within the extents of the display, and the
-//! rectangle specification is fully inclusive (in other words, both i16XMin
-//! and i16XMax are drawn, along with i16YMin and i16YMax).
-//!
-//! \return None.
-//
-//*****************************************************************************
-static void
-Kentec320x240x16_SSD2119RectFill(void *pvDisplayData, const tRectangle *psRect,
-                                 uint32_t ui32Value)
-{
-    int32_t i32Count;
-
-    //
-    // Write the Y extents of the rectangle.
-    //
-    WriteCommand(SSD2119_ENTRY_MODE_REG);
-    WriteData(MAKE_ENTRY_MODE(HORIZ_DIRECTION));
-
-    //
-    // Write the X extents of the rectangle.
-    //
-    WriteCommand(SSD2119_H_RAM_START_REG);
-#if (defined PORTRAIT) || (defined LANDSCAPE)
-    WriteData(MAPPED_X(psRect->i16XMax, psRect->i16YMax));
-#else
-    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
-#endif
-
-    WriteCommand(SSD2119_H_RAM_END_REG);
-#if (defined PORTRAIT) || (defined LANDSCAPE)
-    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
-#else
-    WriteData(MAPPED_X(psRect->i16XMax, psRect->i16YMax));
-#endif
-
-    //
-    // Write the Y extents of the rectangle
-    //
-    WriteCommand(SSD2119_V_RAM_POS_REG);
-#if (defined LANDSCAPE_FLIP) || (defined PORTRAIT)
-    WriteData(MAPPED_Y(psRect->i16XMin, psRect->i16YMin) |
-             (MAPPED_Y(psRect->i16XMax, psRect->i16YMax) << 8));
-#else
-    WriteData(MAPPED_Y(psRect->i16XMax, psRect->i16YMax) |
-             (MAPPED_Y(psRect->i16XMin, psRect->i16YMin) << 8));
-#endif
-
-    //
-    // Set the display cursor to the upper left of the rectangle (in
-    // application coordinate space).
-    //
-    WriteCommand(SSD2119_X_RAM_ADDR_REG);
-    WriteData(MAPPED_X(psRect->i16XMin, psRect->i16YMin));
+    //
     WriteCommand(SSD2119_Y_RAM_ADDR_REG);
-    WriteData(MAPPED_Y(psRect->i16XMin, psRect->i16YMin));
+    WriteData(MAPPED_Y(i32X, i32Y1));
 
     //
-    // Tell the controller to write data into its RAM.
+    // Write the data RAM write command.
     //
     WriteCommand(SSD2119_RAM_DATA_REG);
 
+#if KENTEC_USE_DMA
+    //
+    // Hand long lines to the uDMA controller.
+    //
+    if((i32Y2 - i32Y1 + 1) >= KENTEC_DMA_MIN_PIXELS)
+    {
+        DMAFill(ui32Value, i32Y2 - i32Y1 + 1);
+        return;
+    }
+#endif
+
     //
-    // Loop through the pixels of this filled rectangle.
+    // Loop through the pixels of this vertical line.
     //
-    for(i32Count = ((psRect->i16XMax - psRect->i16XMin + 1) *
-                    (psRect->i16YMax - psRect->i16YMin + 1)); i32Count >= 0;
-        i32Count--)
+    while(i32Y1++ <= i32Y2)
     {
         //
         // Write the pixel value.
         //
         WriteData(ui32Value);
     }
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param psRect is a pointer to the structure describing the rectangle.
+//! \param ui32Value is the color of the rectangle.
+//!
+//! This function fills a rectangle on the display.  The coordinates of the
+//! rectangle are assumed to be within the extents of the display, and the
+//! rectangle specification is fully inclusive (in other words, both i16XMin
+//! and i16XMax are drawn, along with i16YMin and i16YMax).
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119RectFill(void *pvDisplayData, const tRectangle *psRect,
+                                 uint32_t ui32Value)
+{
+    int32_t i32Count;
 
     //
-    // Reset the X extents to the entire screen.
+    // Restrict drawing to the rectangle.
     //
-    WriteCommand(SSD2119_H_RAM_START_REG);
-    WriteData(0x0000);
-    WriteCommand(SSD2119_H_RAM_END_REG);
-    WriteData(0x013f);
+    WindowSet(psRect);
 
     //
-    // Reset the Y extent to the full screen
+    // Loop through the pixels of this filled rectangle, or hand them to the
+    // uDMA controller if there are enough of them.
     //
-    WriteCommand(SSD2119_V_RAM_POS_REG);
-    WriteData(0xef00);
+    i32Count = ((psRect->i16XMax - psRect->i16XMin + 1) *
+                (psRect->i16YMax - psRect->i16YMin + 1));
+#if KENTEC_USE_DMA
+    if(i32Count >= KENTEC_DMA_MIN_PIXELS)
+    {
+        DMAFill(ui32Value, i32Count);
+    }
+    else
+#endif
+    {
+        for(; i32Count > 0; i32Count--)
+        {
+            //
+            // Write the pixel value.
+            //
+            WriteData(ui32Value);
+        }
+    }
+
+    //
+    // Reset the window to the entire screen.
+    //
+    WindowReset();
 }
 
+#endif
+
 //*****************************************************************************
 //
 //! Translates a 24-bit RGB color to a display driver-specific color.
@@ -794,6 +1339,283 @@ Kentec320x240x16_SSD2119ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
     return(DPYCOLORTRANSLATE(ui32Value));
 }
 
+#ifdef KENTEC_FRAMEBUFFER
+//*****************************************************************************
+//
+// When KENTEC_FRAMEBUFFER is defined, drawing operations only update a copy
+// of the screen held in RAM and record the rectangles they changed.  Nothing
+// is sent to the display until Kentec320x240x16_SSD2119Flush() (GrFlush())
+// is called, which then writes each changed rectangle in a single burst.
+// Pixels that are drawn several times between flushes, such as the
+// background and foreground of a string, are therefore only sent once.  The
+// frame buffer takes 150KB of SRAM.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The dimensions of the frame buffer, in application coordinate space.
+//
+//*****************************************************************************
+#if defined(PORTRAIT) || defined(PORTRAIT_FLIP)
+#define FB_WIDTH                LCD_VERTICAL_MAX
+#define FB_HEIGHT               LCD_HORIZONTAL_MAX
+#else
+#define FB_WIDTH                LCD_HORIZONTAL_MAX
+#define FB_HEIGHT               LCD_VERTICAL_MAX
+#endif
+
+//*****************************************************************************
+//
+// The maximum number of dirty rectangles tracked between flushes.  Once all
+// are in use, a new rectangle is merged with the one it adds the fewest
+// pixels to.
+//
+//*****************************************************************************
+#ifndef KENTEC_FB_DIRTY_RECTS
+#define KENTEC_FB_DIRTY_RECTS   8
+#endif
+
+//*****************************************************************************
+//
+// Converts a display color to the frame buffer format.  Pixels are stored
+// with their bytes swapped, in the order they are written to the display, so
+// that a row of the frame buffer can be sent as it is.  The conversion is its
+// own inverse.
+//
+//*****************************************************************************
+#define FB_PIXEL(c)             ((uint16_t)((((c) >> 8) & 0xff) |             \
+                                            (((c) & 0xff) << 8)))
+
+//*****************************************************************************
+//
+// The frame buffer, in application coordinate space, and the rectangles of
+// it that have changed since the last flush.
+//
+//*****************************************************************************
+static uint16_t g_pui16Frame[FB_HEIGHT * FB_WIDTH];
+static tRectangle g_psDirty[KENTEC_FB_DIRTY_RECTS];
+static uint32_t g_ui32NumDirty;
+
+//*****************************************************************************
+//
+// Returns the number of pixels in a rectangle.
+//
+//*****************************************************************************
+static inline int32_t
+RectArea(const tRectangle *psRect)
+{
+    return((psRect->i16XMax - psRect->i16XMin + 1) *
+           (psRect->i16YMax - psRect->i16YMin + 1));
+}
+
+//*****************************************************************************
+//
+// Computes the smallest rectangle containing two others.
+//
+//*****************************************************************************
+static void
+RectUnion(const tRectangle *psA, const tRectangle *psB, tRectangle *psUnion)
+{
+    psUnion->i16XMin = (psA->i16XMin < psB->i16XMin) ? psA->i16XMin :
+                       psB->i16XMin;
+    psUnion->i16YMin = (psA->i16YMin < psB->i16YMin) ? psA->i16YMin :
+                       psB->i16YMin;
+    psUnion->i16XMax = (psA->i16XMax > psB->i16XMax) ? psA->i16XMax :
+                       psB->i16XMax;
+    psUnion->i16YMax = (psA->i16YMax > psB->i16YMax) ? psA->i16YMax :
+                       psB->i16YMax;
+}
+
+//*****************************************************************************
+//
+// Records that a rectangle of the frame buffer has changed.
+//
+//*****************************************************************************
+static void
+DirtyAdd(int32_t i32XMin, int32_t i32YMin, int32_t i32XMax, int32_t i32YMax)
+{
+    tRectangle sRect, sUnion;
+    uint32_t ui32Idx, ui32Best;
+    int32_t i32Grow, i32BestGrow;
+
+    sRect.i16XMin = i32XMin;
+    sRect.i16YMin = i32YMin;
+    sRect.i16XMax = i32XMax;
+    sRect.i16YMax = i32YMax;
+
+    //
+    // Absorb any rectangle that overlaps or touches this one, as long as the
+    // combined rectangle does not contain many pixels that are in neither.
+    // A string drawn a character at a time becomes a single rectangle.
+    //
+    ui32Idx = 0;
+    while(ui32Idx < g_ui32NumDirty)
+    {
+        if((g_psDirty[ui32Idx].i16XMin <= (sRect.i16XMax + 1)) &&
+           (sRect.i16XMin <= (g_psDirty[ui32Idx].i16XMax + 1)) &&
+           (g_psDirty[ui32Idx].i16YMin <= (sRect.i16YMax + 1)) &&
+           (sRect.i16YMin <= (g_psDirty[ui32Idx].i16YMax + 1)))
+        {
+            RectUnion(&sRect, &g_psDirty[ui32Idx], &sUnion);
+            if((RectArea(&sUnion) * 4) <=
+               ((RectArea(&sRect) + RectArea(&g_psDirty[ui32Idx])) * 5))
+            {
+                //
+                // Remove the absorbed rectangle and start again, since the
+                // larger rectangle may now touch others.
+                //
+                sRect = sUnion;
+                g_psDirty[ui32Idx] = g_psDirty[--g_ui32NumDirty];
+                ui32Idx = 0;
+                continue;
+            }
+        }
+        ui32Idx++;
+    }
+
+    //
+    // If there is no room for another rectangle, merge with the one that
+    // grows the least.
+    //
+    if(g_ui32NumDirty == KENTEC_FB_DIRTY_RECTS)
+    {
+        ui32Best = 0;
+        i32BestGrow = 0x7fffffff;
+        for(ui32Idx = 0; ui32Idx < g_ui32NumDirty; ui32Idx++)
+        {
+            RectUnion(&sRect, &g_psDirty[ui32Idx], &sUnion);
+            i32Grow = RectArea(&sUnion) - RectArea(&g_psDirty[ui32Idx]);
+            if(i32Grow < i32BestGrow)
+            {
+                ui32Best = ui32Idx;
+                i32BestGrow = i32Grow;
+            }
+        }
+        RectUnion(&sRect, &g_psDirty[ui32Best], &sUnion);
+        sRect = sUnion;
+        g_psDirty[ui32Best] = g_psDirty[--g_ui32NumDirty];
+    }
+
+    g_psDirty[g_ui32NumDirty++] = sRect;
+}
+
+//*****************************************************************************
+//
+// Draws a pixel into the frame buffer.  See
+// Kentec320x240x16_SSD2119PixelDraw() for a description of the parameters.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119FBPixelDraw(void *pvDisplayData, int32_t i32X,
+                                    int32_t i32Y, uint32_t ui32Value)
+{
+    g_pui16Frame[(i32Y * FB_WIDTH) + i32X] = FB_PIXEL(ui32Value);
+    DirtyAdd(i32X, i32Y, i32X, i32Y);
+}
+
+//*****************************************************************************
+//
+// Draws a horizontal sequence of pixels into the frame buffer.  See
+// Kentec320x240x16_SSD2119PixelDrawMultiple() for a description of the
+// parameters.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119FBPixelDrawMultiple(void *pvDisplayData, int32_t i32X,
+                                            int32_t i32Y, int32_t i32X0,
+                                            int32_t i32Count, int32_t i32BPP,
+                                            const uint8_t *pui8Data,
+                                            const uint8_t *pui8Palette)
+{
+    uint16_t *pui16Pixel;
+    uint32_t ui32Color;
+    int32_t i32Idx;
+
+    if(i32Count <= 0)
+    {
+        return;
+    }
+
+    pui16Pixel = &g_pui16Frame[(i32Y * FB_WIDTH) + i32X];
+    i32BPP &= ~GRLIB_DRIVER_FLAG_NEW_IMAGE;
+    for(i32Idx = 0; i32Idx < i32Count; i32Idx++)
+    {
+        ui32Color = PaletteColorNext(&pui8Data, &i32X0, i32BPP, pui8Palette);
+        pui16Pixel[i32Idx] = FB_PIXEL(ui32Color);
+    }
+    DirtyAdd(i32X, i32Y, i32X + i32Count - 1, i32Y);
+}
+
+//*****************************************************************************
+//
+// Draws a horizontal line into the frame buffer.  See
+// Kentec320x240x16_SSD2119LineDrawH() for a description of the parameters.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119FBLineDrawH(void *pvDisplayData, int32_t i32X1,
+                                    int32_t i32X2, int32_t i32Y,
+                                    uint32_t ui32Value)
+{
+    uint16_t *pui16Pixel;
+    int32_t i32X;
+
+    pui16Pixel = &g_pui16Frame[i32Y * FB_WIDTH];
+    for(i32X = i32X1; i32X <= i32X2; i32X++)
+    {
+        pui16Pixel[i32X] = FB_PIXEL(ui32Value);
+    }
+    DirtyAdd(i32X1, i32Y, i32X2, i32Y);
+}
+
+//*****************************************************************************
+//
+// Draws a vertical line into the frame buffer.  See
+// Kentec320x240x16_SSD2119LineDrawV() for a description of the parameters.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119FBLineDrawV(void *pvDisplayData, int32_t i32X,
+                                    int32_t i32Y1, int32_t i32Y2,
+                                    uint32_t ui32Value)
+{
+    int32_t i32Y;
+
+    for(i32Y = i32Y1; i32Y <= i32Y2; i32Y++)
+    {
+        g_pui16Frame[(i32Y * FB_WIDTH) + i32X] = FB_PIXEL(ui32Value);
+    }
+    DirtyAdd(i32X, i32Y1, i32X, i32Y2);
+}
+
+//*****************************************************************************
+//
+// Fills a rectangle in the frame buffer.  See
+// Kentec320x240x16_SSD2119RectFill() for a description of the parameters.
+//
+//*****************************************************************************
+static void
+Kentec320x240x16_SSD2119FBRectFill(void *pvDisplayData,
+                                   const tRectangle *psRect,
+                                   uint32_t ui32Value)
+{
+    uint16_t *pui16Pixel;
+    int32_t i32X, i32Y;
+
+    for(i32Y = psRect->i16YMin; i32Y <= psRect->i16YMax; i32Y++)
+    {
+        pui16Pixel = &g_pui16Frame[i32Y * FB_WIDTH];
+        for(i32X = psRect->i16XMin; i32X <= psRect->i16XMax; i32X++)
+        {
+            pui16Pixel[i32X] = FB_PIXEL(ui32Value);
+        }
+    }
+    DirtyAdd(psRect->i16XMin, psRect->i16YMin, psRect->i16XMax,
+             psRect->i16YMax);
+}
+#endif
+
 //*****************************************************************************
 //
 //! Flushes any cached drawing operations.
@@ -803,8 +1625,10 @@ Kentec320x240x16_SSD2119ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
 //!
 //! This functions flushes any cached drawing operations to the display.  This
 //! is useful when a local frame buffer is used for drawing operations, and the
-//! flush would copy the local frame buffer to the display.  For the SSD2119
-//! driver, the flush is a no operation.
+//! flush would copy the local frame buffer to the display.  When the driver is
+//! built with KENTEC_FRAMEBUFFER, the rectangles of the frame buffer changed
+//! since the last flush are written to the display; otherwise, the flush is a
+//! no operation.
 //!
 //! \return None.
 //
@@ -812,9 +1636,56 @@ Kentec320x240x16_SSD2119ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
 static void
 Kentec320x240x16_SSD2119Flush(void *pvDisplayData)
 {
+#ifdef KENTEC_FRAMEBUFFER
+    const tRectangle *psRect;
+    const uint16_t *pui16Row;
+    int32_t i32Width, i32Height, i32X;
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_ui32NumDirty; ui32Idx++)
+    {
+        psRect = &g_psDirty[ui32Idx];
+        i32Width = psRect->i16XMax - psRect->i16XMin + 1;
+        i32Height = psRect->i16YMax - psRect->i16YMin + 1;
+        pui16Row = &g_pui16Frame[(psRect->i16YMin * FB_WIDTH) +
+                                 psRect->i16XMin];
+
+        //
+        // Restrict drawing to the rectangle and send its rows, as a single
+        // chain of uDMA transfers if it is large enough.
+        //
+        WindowSet(psRect);
+#if KENTEC_USE_DMA
+        if((i32Width * i32Height) >= KENTEC_DMA_MIN_PIXELS)
+        {
+            DMAStart((const uint8_t *)pui16Row, i32Width * 2, i32Height,
+                     FB_WIDTH * 2);
+            DMAWait();
+            continue;
+        }
+#endif
+        for(; i32Height; i32Height--, pui16Row += FB_WIDTH)
+        {
+            for(i32X = 0; i32X < i32Width; i32X++)
+            {
+                WriteData(FB_PIXEL(pui16Row[i32X]));
+            }
+        }
+    }
+
+    //
+    // Reset the window to the entire screen, if it was changed.
+    //
+    if(g_ui32NumDirty)
+    {
+        WindowReset();
+        g_ui32NumDirty = 0;
+    }
+#else
     //
     // There is nothing to be done.
     //
+#endif
 }
 
 //*****************************************************************************
@@ -834,15 +1705,103 @@ const tDisplay g_sKentec320x240x16_SSD2119 =
     320,
     240,
 #endif
+#ifdef KENTEC_FRAMEBUFFER
+    Kentec320x240x16_SSD2119FBPixelDraw,
+    Kentec320x240x16_SSD2119FBPixelDrawMultiple,
+    Kentec320x240x16_SSD2119FBLineDrawH,
+    Kentec320x240x16_SSD2119FBLineDrawV,
+    Kentec320x240x16_SSD2119FBRectFill,
+#else
     Kentec320x240x16_SSD2119PixelDraw,
     Kentec320x240x16_SSD2119PixelDrawMultiple,
     Kentec320x240x16_SSD2119LineDrawH,
     Kentec320x240x16_SSD2119LineDrawV,
     Kentec320x240x16_SSD2119RectFill,
+#endif
     Kentec320x240x16_SSD2119ColorTranslate,
     Kentec320x240x16_SSD2119Flush
 };
 
+//*****************************************************************************
+//
+//! Draws a block of pixels that are already in the display's format.
+//!
+//! \param i32X is the X coordinate of the upper left of the block.
+//! \param i32Y is the Y coordinate of the upper left of the block.
+//! \param i32Width is the width of the block.
+//! \param i32Height is the height of the block.
+//! \param pui8Data is a pointer to the pixels, row by row from the upper left,
+//! each stored as a big-endian 16-bit 5-6-5 color.
+//!
+//! This function copies a pre-rendered block of pixels, such as a cached
+//! glyph, to the display without any per-pixel conversion.  The block is not
+//! clipped, and is assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Kentec320x240x16_SSD2119BlockDraw(int32_t i32X, int32_t i32Y,
+                                  int32_t i32Width, int32_t i32Height,
+                                  const uint8_t *pui8Data)
+{
+#ifdef KENTEC_FRAMEBUFFER
+    uint8_t *pui8Row;
+    int32_t i32Row, i32Idx;
+
+    //
+    // The frame buffer holds pixels in the same byte order, so the rows are
+    // simply copied.
+    //
+    for(i32Row = 0; i32Row < i32Height; i32Row++)
+    {
+        pui8Row = (uint8_t *)&g_pui16Frame[((i32Y + i32Row) * FB_WIDTH) +
+                                           i32X];
+        for(i32Idx = 0; i32Idx < (i32Width * 2); i32Idx++)
+        {
+            pui8Row[i32Idx] = *pui8Data++;
+        }
+    }
+    DirtyAdd(i32X, i32Y, i32X + i32Width - 1, i32Y + i32Height - 1);
+#else
+    tRectangle sRect;
+    int32_t i32Count;
+
+    //
+    // Restrict drawing to the block.
+    //
+    sRect.i16XMin = i32X;
+    sRect.i16YMin = i32Y;
+    sRect.i16XMax = i32X + i32Width - 1;
+    sRect.i16YMax = i32Y + i32Height - 1;
+    WindowSet(&sRect);
+
+    //
+    // Send the pixels, using the uDMA controller if there are enough of them.
+    //
+    i32Count = i32Width * i32Height;
+#if KENTEC_USE_DMA
+    if(i32Count >= KENTEC_DMA_MIN_PIXELS)
+    {
+        DMAStart(pui8Data, i32Width * 2, i32Height, i32Width * 2);
+        DMAWait();
+    }
+    else
+#endif
+    {
+        for(; i32Count > 0; i32Count--, pui8Data += 2)
+        {
+            WriteData((pui8Data[0] << 8) | pui8Data[1]);
+        }
+    }
+
+    //
+    // Reset the window to the entire screen.
+    //
+    WindowReset();
+#endif
+}
+
 //*****************************************************************************
 //
 //! Initializes the display driver.
@@ -858,7 +1817,10 @@ const tDisplay g_sKentec320x240x16_SSD2119 =
 void
 Kentec320x240x16_SSD2119Init(uint32_t ui32SysClock)
 {
-    uint32_t ui32ClockMS, ui32Count;
+    uint32_t ui32ClockMS;
+#if !KENTEC_USE_DMA
+    uint32_t ui32Count;
+#endif
     tLCDIDDTiming sTimings;
 
     //
@@ -926,6 +1888,23 @@ Kentec320x240x16_SSD2119Init(uint32_t ui32SysClock)
     sTimings.ui8DelayCycles = CYCLES_FROM_TIME_NS(ui32SysClock, 50);
     LCDIDDTimingSet(LCD0_BASE, 0, &sTimings);
 
+#if KENTEC_USE_DMA && !defined(KENTEC_DMA_SIM)
+    //
+    // Set up the uDMA software channel to write bytes to the LIDD data
+    // register.  The interrupt priority must allow the handler to use the
+    // FreeRTOS API.
+    //
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    uDMAEnable();
+    uDMAControlBaseSet(g_psDMAControlTable);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_SW, UDMA_ATTR_ALL);
+    uDMAChannelControlSet(UDMA_CHANNEL_SW | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE |
+                          UDMA_ARB_8);
+    IntPrioritySet(INT_UDMA, 0xe0);
+    IntEnable(INT_UDMA);
+#endif
+
     //
     // Enter sleep mode (if not already there).
     //
@@ -1042,10 +2021,14 @@ Kentec320x240x16_SSD2119Init(uint32_t ui32SysClock)
     // Clear the contents of the display buffer.
     //
     WriteCommand(SSD2119_RAM_DATA_REG);
+#if KENTEC_USE_DMA
+    DMAFill(0x0000, LCD_HORIZONTAL_MAX * LCD_VERTICAL_MAX);
+#else
     for(ui32Count = 0; ui32Count < (320 * 240); ui32Count++)
     {
         WriteData(0x0000);
     }
+#endif
 }
 
 //*****************************************************************************
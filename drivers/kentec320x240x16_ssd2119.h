@@ -0,0 +1,88 @@
+//*****************************************************************************
+//
+// kentec320x240x16_ssd2119.h - Prototypes for the Kentec K350QVG-V2-F TFT
+//                              display driver with an SSD2119 controller.
+//
+// Copyright (c) 2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.0.1.11577 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __KENTEC320X240X16_SSD2119_H__
+#define __KENTEC320X240X16_SSD2119_H__
+
+//*****************************************************************************
+//
+// Set to 1 to send long runs of pixels to the display using the uDMA
+// controller, or 0 to write every pixel with the CPU.
+//
+//*****************************************************************************
+#ifndef KENTEC_USE_DMA
+#define KENTEC_USE_DMA          1
+#endif
+
+//*****************************************************************************
+//
+// Define KENTEC_FRAMEBUFFER to draw into a copy of the screen held in RAM.
+// Changes then only reach the display when GrFlush() is called.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The uDMA transfer statistics returned by
+// Kentec320x240x16_SSD2119DMAStatsGet().
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The number of uDMA transfers started.
+    //
+    uint32_t ui32Transfers;
+
+    //
+    // The number of bytes sent to the display by the uDMA controller.
+    //
+    uint32_t ui32DMABytes;
+
+    //
+    // The number of bytes written to the display by the CPU.  This is only
+    // counted when the driver is built with KENTEC_DMA_SIM.
+    //
+    uint32_t ui32CPUBytes;
+}
+tKentecDMAStats;
+
+//*****************************************************************************
+//
+// Prototypes for the globals exported by this driver.
+//
+//*****************************************************************************
+extern void Kentec320x240x16_SSD2119Init(uint32_t ui32SysClock);
+extern const tDisplay g_sKentec320x240x16_SSD2119;
+extern void Kentec320x240x16_SSD2119BlockDraw(int32_t i32X, int32_t i32Y,
+                                              int32_t i32Width,
+                                              int32_t i32Height,
+                                              const uint8_t *pui8Data);
+#if KENTEC_USE_DMA
+extern void Kentec320x240x16_SSD2119DMAIntHandler(void);
+extern void Kentec320x240x16_SSD2119DMAStatsGet(tKentecDMAStats *psStats);
+#endif
+
+#endif // __KENTEC320X240X16_SSD2119_H__
@@ -31,13 +31,18 @@
 #include "driverlib/sysctl.h"
 #include "grlib/grlib.h"
 #include "drivers/frame.h"
+#include "drivers/glyphcache.h"
 #include "drivers/kentec320x240x16_ssd2119.h"
 #include "drivers/pinout.h"
 #include "drivers/touch.h"
 #include "sensorlib/i2cm_drv.h"
 #include "sensorlib/tmp100.h"
 #include "sensorlib/hw_tmp100.h"
+#include "cpu_load.h"
 #include "lwip_task.h"
+#include "mem_profile.h"
+#include "status_task.h"
+#include "telemetry.h"
 #include "utils/ustdlib.h"
 #include "inc/hw_ints.h"
 #include "inc/hw_memmap.h"
@@ -48,14 +53,27 @@
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
+#include "trace.h"
+#include "crash.h"
 
 uint32_t g_ui32SysClock;
 tContext g_sContext;
-xQueueHandle xQueue1;
-xQueueHandle xQueue2;
+
+//
+// Serializes drawing between the tasks that update the display.
+//
+xSemaphoreHandle g_sDisplayMutex;
 xTaskHandle xHandle;
  xTaskHandle xHandle_time;
  xTaskHandle xHandle_temp;
+
+//
+// The stacks of the application tasks, allocated statically so that only
+// their task control blocks come from the FreeRTOS heap.
+//
+static portSTACK_TYPE g_puxTimeStack[PROFILE_TIME_STACK_SIZE];
+static portSTACK_TYPE g_puxDisplayStack[PROFILE_DISPLAY_STACK_SIZE];
+static portSTACK_TYPE g_puxTempStack[PROFILE_TEMP_STACK_SIZE];
 //uint32_t ui32Base = 0x4A;
 tTMP100 sTMP100;
 //tI2CMInstance sI2CInst;
@@ -83,10 +101,12 @@ volatile bool g_bI2CMSimpleDone = true;
 void
 I2CMSimpleIntHandler(void)
 {
+TraceISREnter(INT_I2C6);
 //
 // Call the I2C master driver interrupt handler.
 //
 I2CMIntHandler(&g_sI2CMSimpleInst);
+TraceISRExit(INT_I2C6);
 }
 
 volatile bool g_bTMP100Done;
@@ -127,13 +147,22 @@ void time_task(void * pvParameters){
 
 
 
-    	    	        if(i == 6)  vTaskSuspend(xHandle);
+    	    	        //
+    	    	        // Hold the display lock while suspending the display
+    	    	        // task so that it is never suspended while holding it.
+    	    	        //
+    	    	        if(i == 6)
+    	    	        {
+    	    	        	xSemaphoreTake(g_sDisplayMutex, portMAX_DELAY);
+    	    	        	vTaskSuspend(xHandle);
+    	    	        	xSemaphoreGive(g_sDisplayMutex);
+    	    	        }
     	    	        if(i == 9)   vTaskResume(xHandle);
 
     	    	        if (i<6 || i>9)
-    	    	        	xQueueOverwrite(xQueue1,
-    	    	        	    	    	        					&i
-    	    	        	    	    	        		 	 	 	 );
+    	    	        {
+    	    	        	TelemetryTimeSet(i);
+    	    	        }
 
 
     	    	       	vTaskDelay(time_delay);
@@ -185,58 +214,83 @@ void temperatureTask(void * pvParameters){
 			//
 			TMP100DataTemperatureGetFloat(&sTMP100, &fTemperature);
 			//
-			// Do something with the new temperature reading.
+			// Publish the new temperature reading.
 			//
-			xQueueOverwrite(xQueue2,
-				    	    	        	    	    	        					&fTemperature
-				    	    	        	    	    	        		 	 	 );
+			TelemetryTemperatureSet(fTemperature);
 	vTaskDelay(time_delay);
 
 
 }
 }
-void displayTask(void * pvParameters){
-
+//*****************************************************************************
+//
+// The shortest time between two display updates.  Measurements that change
+// faster than this are coalesced into one redraw.
+//
+//*****************************************************************************
+#define DISPLAY_MIN_FRAME_MS    100
 
+void displayTask(void * pvParameters){
 
 	char sec[40];
 	char temp[40];
-
-int display_i = 0;
-float r_fTemperature = 0;
-int points_temp = 0;
-int temp_10 = 0;
-int full_temp = 0;
+	tTelemetrySample sSample;
+	int32_t i32Time = 0, i32TempTenths = 0;
+	bool bFirst = true;
 
 	while(1){
-		xQueuePeek(
-		    	   	       	                               xQueue1,
-		    	    	       	                               &display_i,
-		    	    	       	                            1
-		    	    	       	                            );
+		//
+		// Wait for the producers to publish a change.
+		//
+		TelemetryWaitUpdate(portMAX_DELAY);
 
-		xQueuePeek(
-				    	   	       	                               xQueue2,
-				    	    	       	                               &r_fTemperature,
-				    	    	       	                            1
-				    	    	       	                            );
+		//
+		// Take a consistent snapshot of the time and temperature and redraw
+		// only the fields that changed.
+		//
+		TelemetrySampleGet(&sSample);
 
-		temp_10 = r_fTemperature * 10;
-		points_temp = temp_10 % 10;
-		full_temp = temp_10 / 10;
+		xSemaphoreTake(g_sDisplayMutex, portMAX_DELAY);
+
+		if(bFirst || (sSample.i32Time != i32Time))
+		{
+			i32Time = sSample.i32Time;
+			uitoa(sec, i32Time);
+			GlyphCacheStringDraw(&g_sContext, sec, -1, 195, 108);
+		}
 
-		usprintf(temp, "%d.%d", full_temp, points_temp);
-		usprintf(sec, "%d", display_i);
-		GrStringDraw(&g_sContext, sec, -1, 195, 108, 1);
-		GrStringDraw(&g_sContext, temp, -1, 195, 70, 1);
+		if(bFirst ||
+		   (TELEMETRY_CENTI_TO_TENTHS(sSample.i32TempCenti) != i32TempTenths))
+		{
+			i32TempTenths = TELEMETRY_CENTI_TO_TENTHS(sSample.i32TempCenti);
+			ufixtoa(temp, i32TempTenths, 1);
+			GlyphCacheStringDraw(&g_sContext, temp, -1, 195, 70);
+		}
 
+		bFirst = false;
 
-	  vTaskDelay(time_delay);
+		//
+		// Send the changes to the display.
+		//
+		GrFlush(&g_sContext);
+		xSemaphoreGive(g_sDisplayMutex);
+
+		//
+		// Limit the frame rate; updates published meanwhile are picked up
+		// together on the next pass.
+		//
+		vTaskDelay(DISPLAY_MIN_FRAME_MS / portTICK_RATE_MS);
 	}
 }
 int
 main(void)
 {
+    //
+    // Pick up the record of a crash before the last reset, if any, for
+    // /sys/crash.
+    //
+    CrashInit();
+
     //
     // Run from the PLL at 120 MHz.
     //
@@ -276,6 +330,7 @@ main(void)
 
     GrStringDraw(&g_sContext, "Time:", -1, 90, 108, 0);
     GrStringDraw(&g_sContext, "Temperature:", -1, 90, 70, 0);
+    GrFlush(&g_sContext);
 
     SysCtlPeripheralEnable(SYSCTL_PERIPH_I2C6);
     I2CMInit(&g_sI2CMSimpleInst, I2C6_BASE, INT_I2C6, 0xff, 0xff, g_ui32SysClock);
@@ -295,6 +350,7 @@ main(void)
                              GrContextDpyWidthGet(&g_sContext) / 2,
                              (((GrContextDpyHeightGet(&g_sContext) - 24) / 2) +
                               24), 0);
+        GrFlush(&g_sContext);
         while(1)
         {
         }
@@ -307,35 +363,61 @@ main(void)
 
     //Create your tasks here...
 
+    //
+    // Set up the store the tasks publish their measurements to.
+    //
+    TelemetryInit();
+
+    //
+    // Start measuring the CPU load.
+    //
+    CPULoadInit(g_ui32SysClock);
+
+    //
+    // Create the display lock and the task that shows the IP address and the
+    // number of tasks.
+    //
+    g_sDisplayMutex = xSemaphoreCreateMutex();
+    if((g_sDisplayMutex == NULL) || (StatusTaskInit() != 0))
+    {
+        GrContextForegroundSet(&g_sContext, ClrRed);
+        GrStringDrawCentered(&g_sContext, "Failed to create status task!", -1,
+                             GrContextDpyWidthGet(&g_sContext) / 2,
+                             (((GrContextDpyHeightGet(&g_sContext) - 24) / 2) +
+                              24), 0);
+        GrFlush(&g_sContext);
+        while(1)
+        {
+        }
+    }
+    TraceObjectName(g_sDisplayMutex, "display");
+
+
 
+    //
+    // Create the application tasks on their static stacks.
+    //
+    if((xTaskGenericCreate(time_task, (signed portCHAR *)"licznik",
+                           PROFILE_TIME_STACK_SIZE, (void *)1, 4,
+                           &xHandle_time, g_puxTimeStack, NULL) != pdPASS) ||
+       (xTaskGenericCreate(displayTask, (signed portCHAR *)"licznik2",
+                           PROFILE_DISPLAY_STACK_SIZE, (void *)1, 2,
+                           &xHandle, g_puxDisplayStack, NULL) != pdPASS) ||
+       (xTaskGenericCreate(temperatureTask, (signed portCHAR *)"licznik3",
+                           PROFILE_TEMP_STACK_SIZE, (void *)1, 3,
+                           &xHandle_temp, g_puxTempStack, NULL) != pdPASS))
+    {
+        GrContextForegroundSet(&g_sContext, ClrRed);
+        GrStringDrawCentered(&g_sContext, "Failed to create tasks!", -1,
+                             GrContextDpyWidthGet(&g_sContext) / 2,
+                             (((GrContextDpyHeightGet(&g_sContext) - 24) / 2) +
+                              24), 0);
+        GrFlush(&g_sContext);
+        while(1)
+        {
+        }
+    }
 
- xTaskCreate(    	  time_task,
-                                      "licznik",
-                                      1024,
-                                      ( void * ) 1,
-                                      4,
-                                      &xHandle_time
-                                    );
-  xTaskCreate(    	  displayTask,
-                                          "licznik2",
-                                          1024,
-                                          ( void * ) 1,
-                                          2,
-                                          &xHandle
-                                        );
-
-  xTaskCreate(    	  temperatureTask,
-                                           "licznik3",
-                                           1024,
-                                           ( void * ) 1,
-                                           3,
-                                           &xHandle_temp
-                                         );
-
-  xQueue1 =  xQueueCreate( 1,
-                                         sizeof(int) );
-       xQueue2 =  xQueueCreate( 1,
-                                             sizeof(float) );
     //
     // Start the scheduler.  This should not return.
     //
@@ -350,6 +432,7 @@ main(void)
                          GrContextDpyWidthGet(&g_sContext) / 2,
                          (((GrContextDpyHeightGet(&g_sContext) - 24) / 2) + 24),
                          0);
+    GrFlush(&g_sContext);
     while(1)
     {
 
@@ -65,6 +65,10 @@ SECTIONS
     .bss    :   > SRAM
     .sysmem :   > SRAM
     .stack  :   > SRAM
+
+    /* Left as it is at reset, so that the crash record (see crash.c)     */
+    /* survives the reset that follows a crash.                           */
+    .noinit :   > SRAM, type = NOINIT
 }
 
 __STACK_TOP = __stack + 4096;
@@ -30,6 +30,10 @@
 #include "httpserver_raw/httpd.h"
 #include "httpserver_raw/fs.h"
 #include "httpserver_raw/fsdata.h"
+#include "fs_gen.h"
+#include "sysinfo.h"
+#include "telemetry.h"
+#include "trace.h"
 
 //*****************************************************************************
 //
@@ -50,18 +54,67 @@
 
 //*****************************************************************************
 //
-// Initialize the file system.
+// The per-open state of a dynamic file, kept in the pextension field of the
+// file handle.  The generator's own state follows this structure in the same
+// allocation so that fs_close frees both.
 //
 //*****************************************************************************
-extern xQueueHandle xQueue1;
-extern xQueueHandle xQueue2;
+typedef struct
+{
+    //
+    // The generator producing this file.
+    //
+    const tFSGenerator *psGenerator;
+
+    //
+    // True once the generator has reported the end of the file.
+    //
+    bool bEOF;
+}
+tFSGenFile;
+
+//*****************************************************************************
+//
+// The table of registered dynamic file generators.
+//
+//*****************************************************************************
+static const tFSGenerator *g_ppsGenerators[FS_GEN_MAX_ENTRIES];
+static uint32_t g_ui32NumGenerators;
+
+//*****************************************************************************
+//
+// Registers a dynamic file generator.  Generators must be registered before
+// the web server is started.  Returns false if the table is full.
+//
+//*****************************************************************************
+bool
+FSGenRegister(const tFSGenerator *psGenerator)
+{
+    if(g_ui32NumGenerators == FS_GEN_MAX_ENTRIES)
+    {
+        return(false);
+    }
+
+    g_ppsGenerators[g_ui32NumGenerators++] = psGenerator;
+
+    return(true);
+}
 
+//*****************************************************************************
+//
+// Initialize the file system.
+//
+//*****************************************************************************
 void
 fs_init(void)
 {
     //
-    // Nothing special to do for this application.  Flash File System only.
+    // The static content is in the Flash File System.  Register the dynamic
+    // files served by this application.
     //
+    TelemetryFilesRegister();
+    SysInfoFilesRegister();
+    TraceFilesRegister();
 }
 
 //*****************************************************************************
@@ -77,6 +130,58 @@ fs_tick(uint32_t ui32TickMS)
     //
 }
 
+//*****************************************************************************
+//
+// Opens a dynamic file if name matches a registered generator.  Returns true
+// if psFile has been set up for the generator.
+//
+//*****************************************************************************
+static bool
+FSGenOpen(const char *name, struct fs_file *psFile)
+{
+    const tFSGenerator *psGenerator;
+    tFSGenFile *psGenFile;
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_ui32NumGenerators; ui32Idx++)
+    {
+        psGenerator = g_ppsGenerators[ui32Idx];
+        if(strcmp(name, psGenerator->pcName) != 0)
+        {
+            continue;
+        }
+
+        //
+        // Allocate the generator's state behind our own.
+        //
+        psGenFile = mem_malloc(sizeof(tFSGenFile) + psGenerator->ui32StateSize);
+        if(NULL == psGenFile)
+        {
+            return(false);
+        }
+        memset(psGenFile, 0,
+               sizeof(tFSGenFile) + psGenerator->ui32StateSize);
+        psGenFile->psGenerator = psGenerator;
+        if(psGenerator->pfnOpen)
+        {
+            psGenerator->pfnOpen(psGenFile + 1);
+        }
+
+        //
+        // A file without data is read through fs_read, a block at a time.
+        //
+        psFile->data = NULL;
+        psFile->len = 0;
+        psFile->index = 0;
+        psFile->pextension = psGenFile;
+        psFile->http_header_included = 0;
+
+        return(true);
+    }
+
+    return(false);
+}
+
 //*****************************************************************************
 //
 // Open a file and return a handle to the file, if found.  Otherwise,
@@ -98,87 +203,66 @@ fs_open(const char *name)
         return(NULL);
     }
 
-    if(strcmp(name, "/dataread") == 0)
+    //
+    // Is this one of the dynamic files?
+    //
+    if(FSGenOpen(name, psFile))
     {
-    	static char pcBuf[50];   //The buffer for HTTP response
-    	float tempp = 0;
-    	int timee = 0;
-    	int temp_ten;
-    	int points_temp2;
-    	int full_temp2;
-
+        return(psFile);
+    }
 
-    	xQueuePeek(xQueue1, &timee, 1);
-    	xQueuePeek(xQueue2, &tempp, 1);
+    //
+    // Initialize the file system tree pointer to the root of the linked list.
+    //
+    psTree = FS_ROOT;
 
-    			temp_ten = tempp * 10;
-    			points_temp2 = temp_ten % 10;
-    			full_temp2 = temp_ten / 10;
+    //
+    // Begin processing the linked list, looking for the requested file name.
+    //
+    while(NULL != psTree)
+    {
+        //
+        // Compare the requested file "name" to the file name in the
+        // current node.
+        //
+        if(strncmp(name, (char *)psTree->name, psTree->len) == 0)
+        {
+            //
+            // Fill in the data pointer and length values from the
+            // linked list node.
+            //
+            psFile->data = (char *)psTree->data;
+            psFile->len = psTree->len;
 
+            //
+            // For now, we setup the read index to the end of the file,
+            // indicating that all data has been read.
+            //
+            psFile->index = psTree->len;
 
-    	// Create HTTP response here...
-    	usprintf(pcBuf,"time=%d&temperature=%d.%d",timee, full_temp2, points_temp2);
+            //
+            // We are not using any file system extensions in this
+            // application, so set the pointer to NULL.
+            //
+            psFile->pextension = NULL;
 
-		psFile->data = pcBuf;
-		psFile->len = strlen(pcBuf);
-		psFile->index = psFile->len;
-		psFile->pextension = NULL;
+            //
+            // The file system image is built without HTTP headers so
+            // that the server can generate them for each response.
+            //
+            psFile->http_header_included = 0;
 
-		//
-		// Return the psFile system pointer.
-		//
-		return(psFile);
-   }
+            //
+            // Exit the loop and return the file system pointer.
+            //
+            break;
+        }
 
-    else
-    {
-		//
-		// Initialize the file system tree pointer to the root of the linked list.
-		//
-		psTree = FS_ROOT;
-
-		//
-		// Begin processing the linked list, looking for the requested file name.
-		//
-		while(NULL != psTree)
-		{
-			//
-			// Compare the requested file "name" to the file name in the
-			// current node.
-			//
-			if(strncmp(name, (char *)psTree->name, psTree->len) == 0)
-			{
-				//
-				// Fill in the data pointer and length values from the
-				// linked list node.
-				//
-				psFile->data = (char *)psTree->data;
-				psFile->len = psTree->len;
-
-				//
-				// For now, we setup the read index to the end of the file,
-				// indicating that all data has been read.
-				//
-				psFile->index = psTree->len;
-
-				//
-				// We are not using any file system extensions in this
-				// application, so set the pointer to NULL.
-				//
-				psFile->pextension = NULL;
-
-				//
-				// Exit the loop and return the file system pointer.
-				//
-				break;
-			}
-
-			//
-			// If we get here, we did not find the file at this node of the linked
-			// list.  Get the next element in the list.
-			//
-			psTree = psTree->next;
-		}
+        //
+        // If we get here, we did not find the file at this node of the linked
+        // list.  Get the next element in the list.
+        //
+        psTree = psTree->next;
     }
 
     //
@@ -229,8 +313,34 @@ fs_close(struct fs_file *file)
 int
 fs_read(struct fs_file *file, char *buffer, int count)
 {
+    tFSGenFile *psGenFile;
     int iAvailable;
 
+    //
+    // Dynamic files are produced by their generator on demand.
+    //
+    if(file->data == NULL)
+    {
+        psGenFile = file->pextension;
+        if(psGenFile->bEOF)
+        {
+            return(-1);
+        }
+
+        iAvailable = psGenFile->psGenerator->pfnRead(psGenFile + 1, buffer,
+                                                      count);
+        if(iAvailable < 0)
+        {
+            psGenFile->bEOF = true;
+            return(-1);
+        }
+
+        file->len += iAvailable;
+        file->index = file->len;
+
+        return(iAvailable);
+    }
+
     //
     // Check to see if more data is available.
     //
@@ -255,7 +365,7 @@ fs_read(struct fs_file *file, char *buffer, int count)
     //
     // Copy the data.
     //
-    memcpy(buffer, file->data + iAvailable, iAvailable);
+    memcpy(buffer, file->data + file->index, iAvailable);
     file->index += iAvailable;
 
     //
@@ -271,6 +381,18 @@ fs_read(struct fs_file *file, char *buffer, int count)
 //*****************************************************************************
 int fs_bytes_left(struct fs_file *file)
 {
+    tFSGenFile *psGenFile;
+
+    //
+    // The length of a dynamic file is not known until its generator is done,
+    // so report one byte left until then.
+    //
+    if(file->data == NULL)
+    {
+        psGenFile = file->pextension;
+        return(psGenFile->bEOF ? 0 : 1);
+    }
+
     //
     // Return the number of bytes left to be read from this file.
     //
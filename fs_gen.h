@@ -0,0 +1,89 @@
+//*****************************************************************************
+//
+// fs_gen.h - Dynamic file generators for the lwIP web server file system.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __FS_GEN_H__
+#define __FS_GEN_H__
+
+//*****************************************************************************
+//
+// The maximum number of generators that can be registered.
+//
+//*****************************************************************************
+#define FS_GEN_MAX_ENTRIES      12
+
+//*****************************************************************************
+//
+// The value returned by a generator's read function once the whole file has
+// been produced.
+//
+//*****************************************************************************
+#define FS_GEN_EOF              (-1)
+
+//*****************************************************************************
+//
+// A dynamic file.  When the web server opens a file whose name matches
+// pcName, ui32StateSize bytes of per-open state are allocated (and zeroed)
+// and pfnOpen, if not NULL, is called to initialize them.  The server then
+// calls pfnRead each time it has room in the TCP send buffer.  pfnRead must
+// write at most iCount bytes to pcBuf and return the number of bytes written,
+// 0 if no data is available yet (the server will ask again later), or
+// FS_GEN_EOF once the file is complete.  Files are therefore produced a block
+// at a time and never need a buffer for the whole response.
+//
+// Generators run in the lwIP TCP/IP thread and must not block.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The file name, including the leading '/', e.g. "/dataread".
+    //
+    const char *pcName;
+
+    //
+    // The number of bytes of per-open state to allocate for this file.
+    //
+    uint32_t ui32StateSize;
+
+    //
+    // Initializes the per-open state.  May be NULL.
+    //
+    void (*pfnOpen)(void *pvState);
+
+    //
+    // Produces the next block of the file.
+    //
+    int (*pfnRead)(void *pvState, char *pcBuf, int iCount);
+}
+tFSGenerator;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void fs_init(void);
+extern bool FSGenRegister(const tFSGenerator *psGenerator);
+
+#endif // __FS_GEN_H__
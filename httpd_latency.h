@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2001-2003 Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * This file is part of the lwIP TCP/IP stack.
+ *
+ */
+#ifndef __HTTPD_LATENCY_H__
+#define __HTTPD_LATENCY_H__
+
+#include "lwip/opt.h"
+
+/** Set this to 1 to record the latency of each request into per-route
+ * histograms, see httpd_latency_get().  Requires HTTPD_LATENCY_NOW().
+ */
+#ifndef LWIP_HTTPD_LATENCY
+#define LWIP_HTTPD_LATENCY                  0
+#endif
+
+#if LWIP_HTTPD_LATENCY
+
+/** Returns a free-running u32_t timestamp.  Intervals are measured in its
+ * ticks, so it should run fast (e.g. at the CPU clock) and must wrap at
+ * 2^32.  No default is provided.
+ */
+#ifndef HTTPD_LATENCY_NOW
+#error LWIP_HTTPD_LATENCY needs HTTPD_LATENCY_NOW()
+#endif
+
+/** Number of routes (distinct URIs) with their own histograms.  The last
+ * route collects the requests for every URI seen once the others are taken.
+ */
+#ifndef HTTPD_LATENCY_ROUTES
+#define HTTPD_LATENCY_ROUTES                8
+#endif
+
+/** Number of characters of the URI that identify a route */
+#ifndef HTTPD_LATENCY_URI_LEN
+#define HTTPD_LATENCY_URI_LEN               20
+#endif
+
+/** Histogram buckets are powers of two: bucket 0 counts intervals shorter
+ * than 2^HTTPD_LATENCY_MIN_SHIFT ticks, bucket n counts intervals from
+ * 2^(HTTPD_LATENCY_MIN_SHIFT + n - 1) up to twice that, and the last bucket
+ * also counts everything longer.
+ */
+#ifndef HTTPD_LATENCY_MIN_SHIFT
+#define HTTPD_LATENCY_MIN_SHIFT             8
+#endif
+#ifndef HTTPD_LATENCY_BUCKETS
+#define HTTPD_LATENCY_BUCKETS               24
+#endif
+
+/** The phases of a request that are timed */
+enum httpd_latency_phase {
+  /* Connection accepted -> first byte of its first request received */
+  HTTPD_LATENCY_ACCEPT,
+  /* Time spent parsing the request, excluding the handler */
+  HTTPD_LATENCY_PARSE,
+  /* Time spent in fs_open() and fs_read(), producing the response */
+  HTTPD_LATENCY_HANDLER,
+  /* First byte of the request received -> last byte of the response
+     acknowledged; on a connection closed after the response it is only
+     measured if everything sent was acknowledged before the close, see
+     ack_missed */
+  HTTPD_LATENCY_ACK,
+  HTTPD_LATENCY_PHASES
+};
+
+/** The latency histograms of one route */
+struct httpd_latency_route {
+  /* The URI, without parameters, or "" if the route is unused; the last
+     route is always "*" */
+  char uri[HTTPD_LATENCY_URI_LEN + 1];
+  /* The longest interval recorded for each phase */
+  u32_t max[HTTPD_LATENCY_PHASES];
+  /* The number of intervals in each bucket for each phase */
+  u32_t hist[HTTPD_LATENCY_PHASES][HTTPD_LATENCY_BUCKETS];
+  /* The number of responses whose HTTPD_LATENCY_ACK phase was not measured
+     because the connection was closed (which stops the server from seeing
+     further ACKs) or reset before they were acknowledged */
+  u32_t ack_missed;
+};
+
+const struct httpd_latency_route *httpd_latency_get(u8_t route);
+void httpd_latency_reset(void);
+
+#endif /* LWIP_HTTPD_LATENCY */
+
+#endif /* __HTTPD_LATENCY_H__ */
@@ -30,12 +30,26 @@
 #include "utils/lwiplib.h"
 #include "utils/locator.h"
 #include "utils/ustdlib.h"
-#include "grlib/grlib.h"
 #include "httpserver_raw/httpd.h"
 #include "lwip_task.h"
+#include "trace.h"
+#include "crash.h"
+#include "fs_gen.h"
+#include "status_task.h"
 
 extern uint32_t g_ui32SysClock;
-extern tContext g_sContext;
+
+//*****************************************************************************
+//
+// Called by lwIP when the interface's address or state, or the link state,
+// changes.  The status task displays the new address.
+//
+//*****************************************************************************
+static void
+NetIFStatusChanged(struct netif *psNetIF)
+{
+    StatusTaskEvent(STATUS_EVENT_IP);
+}
 
 //*****************************************************************************
 //
@@ -57,8 +71,15 @@ SetupServices(void *pvArg)
     LocatorAppTitleSet("DK-TM4C129X freertos_demo");
 
     //
-    // Initialize the sample httpd server.
+    // Have the status task display the IP address whenever it changes.
+    //
+    netif_set_status_callback(netif_default, NetIFStatusChanged);
+    StatusTaskEvent(STATUS_EVENT_IP);
+
     //
+    // Register the dynamic files and initialize the sample httpd server.
+    //
+    fs_init();
     httpd_init();
 
 }
@@ -120,154 +141,11 @@ lwIPTaskInit(void)
 
 //
 // This hook is called by FreeRTOS when an stack overflow error is detected.
+// The overflow is recorded for the next boot and the processor is reset.
 //
 //*****************************************************************************
 void
 vApplicationStackOverflowHook(xTaskHandle *pxTask, signed char *pcTaskName)
 {
-
-    // A fatal FreeRTOS error was detected
-
-    while(1)
-    {
-    }
-}
-
-#if (RUN_HTTP_SERVER)
-
-static uint32_t g_ui32Tasks = 0;
-static uint32_t g_ui32IPAddress = 0xffffffff;
-static char g_pcIPString[24];
-
-//*****************************************************************************
-//
-// Displays the IP address in a human-readable format.
-//
-//*****************************************************************************
-static void
-DisplayIP(uint32_t ui32IP)
-{
-    uint32_t ui32Loop, ui32Idx, ui32Value;
-
-    //
-    // If there is no IP address, indicate that one is being acquired.
-    //
-    if(ui32IP == 0)
-    {
-        GrStringDraw(&g_sContext, "IP address: acquiring...", -1, 50, 50, 1);
-        return;
-    }
-
-    //
-    // Set the initial index into the string that is being constructed.
-    //
-    ui32Idx = 0;
-
-    //
-    // Start the string with four spaces.  Not all will necessarily be used,
-    // depending upon the length of the IP address string.
-    //
-    for(ui32Loop = 0; ui32Loop < 4; ui32Loop++)
-    {
-        g_pcIPString[ui32Idx++] = ' ';
-    }
-
-    //
-    // Loop through the four bytes of the IP address.
-    //
-    for(ui32Loop = 0; ui32Loop < 32; ui32Loop += 8)
-    {
-        //
-        // Extract this byte from the IP address word.
-        //
-        ui32Value = (ui32IP >> ui32Loop) & 0xff;
-
-        //
-        // Convert this byte into ASCII, using only the characters required.
-        //
-        if(ui32Value > 99)
-        {
-            g_pcIPString[ui32Idx++] = '0' + (ui32Value / 100);
-        }
-        if(ui32Value > 9)
-        {
-            g_pcIPString[ui32Idx++] = '0' + ((ui32Value / 10) % 10);
-        }
-        g_pcIPString[ui32Idx++] = '0' + (ui32Value % 10);
-
-        //
-        // Add a dot to separate this byte from the next.
-        //
-        g_pcIPString[ui32Idx++] = '.';
-    }
-
-    //
-    // Fill the remainder of the string buffer with spaces.
-    //
-    for(ui32Loop = ui32Idx - 1; ui32Loop < 20; ui32Loop++)
-    {
-        g_pcIPString[ui32Loop] = ' ';
-    }
-
-    //
-    // Null terminate the string at the appropriate place, based on the length
-    // of the string version of the IP address.  There may or may not be
-    // trailing spaces that remain.
-    //
-    g_pcIPString[ui32Idx + 3 - ((ui32Idx - 12) / 2)] = '\0';
-
-    //
-    // Display the string.  The horizontal position and the number of leading
-    // spaces utilized depend on the length of the string version of the IP
-    // address.  The end result is the IP address centered in the provided
-    // space with leading/trailing spaces as required to clear the remainder of
-    // the space.
-    //
-
-    GrStringDraw(&g_sContext, g_pcIPString + ((ui32Idx - 12) / 2), -1, 130, 50, 1);
-}
-
-void
-vApplicationIdleHook(void)
-{
-	char buf[20];
-
-	uint32_t ui32Temp = uxTaskGetNumberOfTasks() - 1;
-
-	if(ui32Temp != g_ui32Tasks)
-	{
-		g_ui32Tasks = ui32Temp;
-
-	    usprintf(buf, "Tasks: %d", g_ui32Tasks);
-
-		GrStringDraw(&g_sContext, buf, -1, 50, 100, 1);
-	}
-
-
-	//
-    // Get the current IP address.
-    //
-	ui32Temp = lwIPLocalIPAddrGet();
-
-    //
-    // See if the IP address has changed.
-    //
-    if(ui32Temp != g_ui32IPAddress)
-    {
-        //
-        // Save the current IP address.
-        //
-        g_ui32IPAddress = ui32Temp;
-
-        //
-        // Update the display of the IP address.
-        //
-        DisplayIP(ui32Temp);
-    }
-}
-#else
-void vApplicationIdleHook(void)
-{
-	// do nothing
+    CrashStackOverflow((const char *)pcTaskName);
 }
-#endif
@@ -33,6 +33,14 @@
 #ifndef __LWIPOPTS_H__
 #define __LWIPOPTS_H__
 
+//*****************************************************************************
+//
+// The memory sizes defined as PROFILE_* below are set by the RAM budget
+// profile selected in mem_profile.h.
+//
+//*****************************************************************************
+#include "mem_profile.h"
+
 //*****************************************************************************
 //
 // ---------- Stellaris / lwIP Port Options ----------
@@ -43,6 +51,33 @@
 #define LWIP_HTTPD_SSI                  1
 #define LWIP_HTTPD_CGI                  1
 #define LWIP_HTTPD_DYNAMIC_HEADERS      1
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 1           // default is 0
+#define LWIP_HTTPD_LATENCY              1           // default is 0
+#include "cpu_time.h"
+#define HTTPD_LATENCY_NOW()             CPULoadTimeGet()
+#define LWIP_INPUT_LATENCY              1           // default is 0
+#define LWIP_LATENCY_NOW()              CPULoadTimeGet()
+#define LWIP_RX_COALESCE                1           // default is 0
+extern void TraceISREnter(unsigned long ulInt);
+extern void TraceISRExit(unsigned long ulInt);
+#define LWIP_INT_ENTER(ui32Int)         TraceISREnter(ui32Int)
+#define LWIP_INT_EXIT(ui32Int)          TraceISRExit(ui32Int)
+//
+// The Ethernet DMA cannot read flash, so the Ethernet driver copies a packet
+// that refers to flash into a new SRAM pbuf every time it is sent, and again
+// for every retransmission.  Have the web server let tcp_write() copy file
+// and header data out of flash instead: it is then copied once, into SRAM
+// segments that the driver passes to the DMA as they are, and headers and
+// file data share segments.
+//
+// With these overrides in place, the parts of httpd.c that handle data sent
+// by reference only apply if they are removed again: the second send queue
+// entry HTTP_WRITE_QUEUE_COST() counts for referenced data, and the default
+// HTTP_IS_HDR_VOLATILE() that copies only the generated Content-Length
+// header.
+//
+#define HTTP_IS_DATA_VOLATILE(hs)       TCP_WRITE_FLAG_COPY
+#define HTTP_IS_HDR_VOLATILE(hs, ptr)   TCP_WRITE_FLAG_COPY
 //#define INCLUDE_HTTPD_DEBUG
 #define LWIP_HTTPD_CGI                  1
 #define LWIP_HTTPD_SSI                  1
@@ -73,7 +108,7 @@
 //*****************************************************************************
 //#define MEM_LIBC_MALLOC                 0
 #define MEM_ALIGNMENT                   4           // default is 1
-#define MEM_SIZE                        (64 * 1024)  // default is 1600, was 16K
+#define MEM_SIZE                        PROFILE_MEM_SIZE // default is 1600
 //#define MEMP_OVERFLOW_CHECK             0
 //#define MEMP_SANITY_CHECK               0
 //#define MEM_USE_POOLS                   0
@@ -84,12 +119,12 @@
 // ---------- Internal Memory Pool Sizes ----------
 //
 //*****************************************************************************
-#define MEMP_NUM_PBUF                     64    // Default 16
+#define MEMP_NUM_PBUF                     PROFILE_MEMP_NUM_PBUF // Default 16
 //#define MEMP_NUM_RAW_PCB                4
 //#define MEMP_NUM_UDP_PCB                4
-#define MEMP_NUM_TCP_PCB                  40    // Default is 5
+#define MEMP_NUM_TCP_PCB                  PROFILE_MEMP_NUM_TCP_PCB // Default is 5
 //#define MEMP_NUM_TCP_PCB_LISTEN         8
-#define MEMP_NUM_TCP_SEG                  48    // Default is 16
+#define MEMP_NUM_TCP_SEG                  PROFILE_MEMP_NUM_TCP_SEG // Default is 16
 //#define MEMP_NUM_REASSDATA              5
 //#define MEMP_NUM_ARP_QUEUE              30
 //#define MEMP_NUM_IGMP_GROUP             8
@@ -98,7 +133,7 @@
 //#define MEMP_NUM_NETCONN                4
 //#define MEMP_NUM_TCPIP_MSG_API          8
 //#define MEMP_NUM_TCPIP_MSG_INPKT        8
-#define PBUF_POOL_SIZE                    64    // Default 16
+#define PBUF_POOL_SIZE                    PROFILE_PBUF_POOL_SIZE // Default 16
 
 //*****************************************************************************
 //
@@ -220,13 +255,13 @@
 //*****************************************************************************
 //#define LWIP_TCP                        1
 //#define TCP_TTL                         (IP_DEFAULT_TTL)
-#define TCP_WND                         4096   // default is 2048
+#define TCP_WND                         PROFILE_TCP_WND // default is 2048
 //#define TCP_MAXRTX                      12
 //#define TCP_SYNMAXRTX                   6
 //#define TCP_QUEUE_OOSEQ                 1
 #define TCP_MSS                        1500        // default is 128
 //#define TCP_CALCULATE_EFF_SEND_MSS      1
-#define TCP_SND_BUF                     (6 * TCP_MSS)
+#define TCP_SND_BUF                     PROFILE_TCP_SND_BUF
                                                     // default is 256
 #define TCP_SND_QUEUELEN                (MEMP_NUM_TCP_SEG)
                                                     // default is (4 * (TCP_SND_BUF/TCP_MSS))
@@ -247,8 +282,20 @@
 // ---------- Pbuf options ----------
 //
 //*****************************************************************************
+//
+// The Ethernet driver receives straight into pool pbufs, one per receive
+// descriptor, so the pool buffer size is the receive buffer size.  Sized for
+// a full Ethernet frame (1518 bytes with the FCS) rounded up to a multiple
+// of 32, every frame arrives in a single pbuf rather than a chain of three.
+// With the pbuf header this takes 1552 bytes per pool entry, so the default
+// profile's pool of 24 is 37248 bytes, against 64 * 528 = 33792 bytes for
+// the former 64 buffers of 512 bytes; in exchange it holds 24 frames rather
+// than 64 small ones.  Eight pbufs are always attached to the receive
+// descriptors, leaving sixteen, the receive coalescing budget, in flight to
+// the stack.  /sys/net reports the pool layout.
+//
 #define PBUF_LINK_HLEN                  16          // default is 14
-#define PBUF_POOL_BUFSIZE               512
+#define PBUF_POOL_BUFSIZE               1536
                                                     // default is LWIP_MEM_ALIGN_SIZE(TCP_MSS+40+PBUF_LINK_HLEN)
 #define ETH_PAD_SIZE                    0           // default is 0
 
@@ -259,7 +306,7 @@
 //*****************************************************************************
 //#define LWIP_NETIF_HOSTNAME             0
 //#define LWIP_NETIF_API                  0
-//#define LWIP_NETIF_STATUS_CALLBACK      0
+#define LWIP_NETIF_STATUS_CALLBACK      1           // default is 0
 //#define LWIP_NETIF_LINK_CALLBACK        0
 //#define LWIP_NETIF_HWADDRHINT           0
 
@@ -278,7 +325,14 @@
 //*****************************************************************************
 #define TCPIP_THREAD_NAME              "tcpip_thread"
 #define TCPIP_THREAD_STACKSIZE          1024
-#define TCPIP_THREAD_PRIO               3
+//
+// The TCP/IP thread, and the Ethernet interrupt task above it, run above the
+// application tasks (priorities 1 to 4) so that a busy application task
+// cannot hold off the network.
+//
+#define TCPIP_THREAD_PRIO               5
+#define LWIP_INTERRUPT_TASK_PRIO        (TCPIP_THREAD_PRIO + 1)
+#define STACKSIZE_LWIPINTTASK           128
 #define TCPIP_MBOX_SIZE                 32
 //#define SLIPIF_THREAD_NAME             "slipif_loop"
 //#define SLIPIF_THREAD_STACKSIZE         0
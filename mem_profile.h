@@ -0,0 +1,172 @@
+//*****************************************************************************
+//
+// mem_profile.h - RAM budget profiles for lwIP and FreeRTOS.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __MEM_PROFILE_H__
+#define __MEM_PROFILE_H__
+
+//*****************************************************************************
+//
+// The 256 KB of SRAM is shared mainly between the lwIP heap (MEM_SIZE), the
+// lwIP memory pools (above all the receive pbuf pool, PBUF_POOL_SIZE buffers
+// of PBUF_POOL_BUFSIZE bytes), the FreeRTOS heap (configTOTAL_HEAP_SIZE) and
+// the task stacks.  The network buffers are sized together by a profile,
+// selected by defining MEM_PROFILE, either here or on the compiler command
+// line (for example --define=MEM_PROFILE=MEM_PROFILE_LOW_MEMORY).
+// lwipopts.h and FreeRTOSConfig.h take their sizes from the profile.
+//
+// To see how the RAM is actually used by a build, run
+//
+//     python tools/ram_report.py Debug/<project>_linkInfo.xml
+//
+// which sums the statically allocated RAM by subsystem from the link map.
+// /sys/net reports how much of the lwIP heap and pools is used at run time.
+//
+//*****************************************************************************
+#define MEM_PROFILE_DEFAULT     0
+#define MEM_PROFILE_MANY_CLIENTS                                              \
+                                1
+#define MEM_PROFILE_BIG_THROUGHPUT                                            \
+                                2
+#define MEM_PROFILE_LOW_MEMORY  3
+
+#ifndef MEM_PROFILE
+#define MEM_PROFILE             MEM_PROFILE_DEFAULT
+#endif
+
+//*****************************************************************************
+//
+// Each profile sets:
+//
+// PROFILE_MEM_SIZE         the lwIP heap, which holds the data queued for
+//                          sending (TCP_SND_BUF per connection), in bytes.
+// PROFILE_PBUF_POOL_SIZE   the number of receive pbufs; NUM_RX_DESCRIPTORS
+//                          of them are always attached to the receive ring.
+// PROFILE_MEMP_NUM_PBUF    the number of pbufs referring to ROM or RAM.
+// PROFILE_MEMP_NUM_TCP_PCB the number of simultaneous TCP connections.
+// PROFILE_MEMP_NUM_TCP_SEG the number of queued TCP segments, shared by all
+//                          connections.
+// PROFILE_TCP_WND          the TCP receive window, in bytes.
+// PROFILE_TCP_SND_BUF      the TCP send buffer per connection, in bytes.
+//
+//*****************************************************************************
+#if MEM_PROFILE == MEM_PROFILE_DEFAULT
+
+//
+// A balance of connections and throughput for a handful of browsers.
+//
+#define PROFILE_MEM_SIZE        (64 * 1024)
+#define PROFILE_PBUF_POOL_SIZE  24
+#define PROFILE_MEMP_NUM_PBUF   64
+#define PROFILE_MEMP_NUM_TCP_PCB                                              \
+                                40
+#define PROFILE_MEMP_NUM_TCP_SEG                                              \
+                                48
+#define PROFILE_TCP_WND         4096
+#define PROFILE_TCP_SND_BUF     (6 * TCP_MSS)
+
+#elif MEM_PROFILE == MEM_PROFILE_MANY_CLIENTS
+
+//
+// Many simultaneous connections, each with a small window and send buffer,
+// such as many clients polling the telemetry files.
+//
+#define PROFILE_MEM_SIZE        (64 * 1024)
+#define PROFILE_PBUF_POOL_SIZE  32
+#define PROFILE_MEMP_NUM_PBUF   96
+#define PROFILE_MEMP_NUM_TCP_PCB                                              \
+                                80
+#define PROFILE_MEMP_NUM_TCP_SEG                                              \
+                                96
+#define PROFILE_TCP_WND         (2 * TCP_MSS)
+#define PROFILE_TCP_SND_BUF     (2 * TCP_MSS)
+
+#elif MEM_PROFILE == MEM_PROFILE_BIG_THROUGHPUT
+
+//
+// A few connections moving a lot of data, with large windows and send
+// buffers and the receive pool to back them.
+//
+#define PROFILE_MEM_SIZE        (96 * 1024)
+#define PROFILE_PBUF_POOL_SIZE  48
+#define PROFILE_MEMP_NUM_PBUF   64
+#define PROFILE_MEMP_NUM_TCP_PCB                                              \
+                                16
+#define PROFILE_MEMP_NUM_TCP_SEG                                              \
+                                128
+#define PROFILE_TCP_WND         (8 * TCP_MSS)
+#define PROFILE_TCP_SND_BUF     (12 * TCP_MSS)
+
+#elif MEM_PROFILE == MEM_PROFILE_LOW_MEMORY
+
+//
+// The least RAM that still serves a couple of browsers, leaving the rest to
+// the application.
+//
+#define PROFILE_MEM_SIZE        (24 * 1024)
+#define PROFILE_PBUF_POOL_SIZE  16
+#define PROFILE_MEMP_NUM_PBUF   16
+#define PROFILE_MEMP_NUM_TCP_PCB                                              \
+                                8
+#define PROFILE_MEMP_NUM_TCP_SEG                                              \
+                                16
+#define PROFILE_TCP_WND         (2 * TCP_MSS)
+#define PROFILE_TCP_SND_BUF     (2 * TCP_MSS)
+
+#else
+#error "Unknown MEM_PROFILE"
+#endif
+
+//*****************************************************************************
+//
+// The stacks of the application tasks, in words.  They are allocated
+// statically, next to each task, so they show up in the link map and a task
+// can not fail to start for lack of heap.  Each is sized for the deepest
+// call the task makes, with room to spare; after a soak run, /sys/stacks
+// reports the peak use of every task and the size it recommends for each.
+// The table of stack sizes in stack_monitor.c must list any task added.
+//
+// A task on a static stack must never be deleted: FreeRTOS V7 hands the
+// stack of a deleted task back to the heap.  INCLUDE_vTaskDelete is 0 in
+// FreeRTOSConfig.h for this reason.
+//
+//*****************************************************************************
+#define PROFILE_TIME_STACK_SIZE 256
+#define PROFILE_TEMP_STACK_SIZE 384
+#define PROFILE_DISPLAY_STACK_SIZE                                            \
+                                512
+#define PROFILE_STATUS_STACK_SIZE                                             \
+                                512
+
+//*****************************************************************************
+//
+// The FreeRTOS heap, in bytes.  With the task stacks above allocated
+// statically it only holds what FreeRTOS V7 can not take from the caller:
+// the task control blocks, the idle task's and the TCP/IP thread's stacks
+// (configMINIMAL_STACK_SIZE and TCPIP_THREAD_STACKSIZE words), the semaphores
+// and the TCP/IP thread's mailbox.
+//
+//*****************************************************************************
+#define PROFILE_TOTAL_HEAP_SIZE 8192
+
+#endif // __MEM_PROFILE_H__
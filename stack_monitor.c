@@ -0,0 +1,243 @@
+//*****************************************************************************
+//
+// stack_monitor.c - Measures the stack used by each task.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lwip/opt.h"
+#include "utils/ustdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lwip_task.h"
+#include "mem_profile.h"
+#include "stack_monitor.h"
+
+//*****************************************************************************
+//
+// The kernel fills each task's stack with a known value when it creates the
+// task, and a task's high-water mark is the number of words at the far end of
+// its stack that still hold that value.  The status task samples the
+// high-water marks every STACK_MONITOR_PERIOD_MS and keeps the least seen for
+// each task, so that a soak run records the peak use of every task, including
+// those that have since been deleted.  /sys/stacks reports the peaks with a
+// recommended size for each stack.
+//
+// The high-water mark only shows the deepest use that has actually happened;
+// the recommendation is only as good as the run it was measured over.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The stack sizes, in words, of the tasks that this application creates.  The
+// kernel does not report them.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Size;
+}
+tStackSize;
+
+static const tStackSize g_psStackSizes[] =
+{
+    { "IDLE", configMINIMAL_STACK_SIZE },
+    { "licznik", PROFILE_TIME_STACK_SIZE },
+    { "licznik2", PROFILE_DISPLAY_STACK_SIZE },
+    { "licznik3", PROFILE_TEMP_STACK_SIZE },
+    { "status", PROFILE_STATUS_STACK_SIZE },
+#if (RUN_HTTP_SERVER)
+    { TCPIP_THREAD_NAME, TCPIP_THREAD_STACKSIZE },
+    { "eth_int", STACKSIZE_LWIPINTTASK },
+#endif
+};
+
+#define NUM_STACK_SIZES         (sizeof(g_psStackSizes) /                    \
+                                 sizeof(g_psStackSizes[0]))
+
+//*****************************************************************************
+//
+// The tasks seen so far and the number of samples taken.  Only the status
+// task updates them; readers copy them out in a critical section.
+//
+//*****************************************************************************
+static tStackMonitorTask g_psTasks[STACK_MONITOR_TASKS_MAX];
+static uint32_t g_ui32NumTasks;
+static uint32_t g_ui32Samples;
+
+//*****************************************************************************
+//
+// The task states read by a sample.  Kept out of the caller's stack.
+//
+//*****************************************************************************
+static xTaskStatusType g_psStatus[STACK_MONITOR_TASKS_MAX];
+
+//*****************************************************************************
+//
+// Returns the stack size of the named task, or 0 if it is not known.  The
+// kernel truncates task names to configMAX_TASK_NAME_LEN - 1 characters.
+//
+//*****************************************************************************
+static uint32_t
+StackMonitorSizeGet(const char *pcName)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < NUM_STACK_SIZES; ui32Idx++)
+    {
+        if(ustrncmp(pcName, g_psStackSizes[ui32Idx].pcName,
+                    configMAX_TASK_NAME_LEN - 1) == 0)
+        {
+            return(g_psStackSizes[ui32Idx].ui32Size);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Returns the recommended size of a stack: the peak use plus
+// STACK_MONITOR_MARGIN_PCT, rounded up to a multiple of STACK_MONITOR_ALIGN.
+//
+//*****************************************************************************
+static uint32_t
+StackMonitorRecommend(uint32_t ui32Size, uint32_t ui32MinFree)
+{
+    uint32_t ui32Used;
+
+    if((ui32Size == 0) || (ui32MinFree > ui32Size))
+    {
+        return(0);
+    }
+
+    ui32Used = ui32Size - ui32MinFree;
+    ui32Used += ((ui32Used * STACK_MONITOR_MARGIN_PCT) + 99) / 100;
+
+    return((ui32Used + STACK_MONITOR_ALIGN - 1) &
+           ~(uint32_t)(STACK_MONITOR_ALIGN - 1));
+}
+
+//*****************************************************************************
+//
+// Samples the high-water mark of every task.  Called periodically by the
+// status task; it walks every task's stack, so it must not be called from a
+// time-critical task.
+//
+//*****************************************************************************
+void
+StackMonitorSample(void)
+{
+    xTaskStatusType *psStatus;
+    tStackMonitorTask *psTask;
+    uint32_t ui32NumStatus, ui32Idx, ui32Task;
+
+    ui32NumStatus = uxTaskGetSystemState(g_psStatus, STACK_MONITOR_TASKS_MAX,
+                                         NULL);
+
+    for(ui32Idx = 0; ui32Idx < ui32NumStatus; ui32Idx++)
+    {
+        psStatus = &g_psStatus[ui32Idx];
+
+        //
+        // Find the task's record.
+        //
+        for(ui32Task = 0; ui32Task < g_ui32NumTasks; ui32Task++)
+        {
+            if(ustrncmp(g_psTasks[ui32Task].pcName,
+                        (const char *)psStatus->pcTaskName,
+                        configMAX_TASK_NAME_LEN) == 0)
+            {
+                break;
+            }
+        }
+
+        psTask = &g_psTasks[ui32Task];
+
+        taskENTER_CRITICAL();
+        if(ui32Task == g_ui32NumTasks)
+        {
+            //
+            // A new task; start its record if there is room.
+            //
+            if(ui32Task < STACK_MONITOR_TASKS_MAX)
+            {
+                ustrncpy(psTask->pcName, (const char *)psStatus->pcTaskName,
+                         configMAX_TASK_NAME_LEN);
+                psTask->pcName[configMAX_TASK_NAME_LEN - 1] = 0;
+                psTask->ui32Size = StackMonitorSizeGet(psTask->pcName);
+                psTask->ui32MinFree = psStatus->usStackHighWaterMark;
+                psTask->ui32Recommended =
+                    StackMonitorRecommend(psTask->ui32Size,
+                                          psTask->ui32MinFree);
+                g_ui32NumTasks++;
+            }
+        }
+        else if(psStatus->usStackHighWaterMark < psTask->ui32MinFree)
+        {
+            psTask->ui32MinFree = psStatus->usStackHighWaterMark;
+            psTask->ui32Recommended =
+                StackMonitorRecommend(psTask->ui32Size, psTask->ui32MinFree);
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    g_ui32Samples++;
+}
+
+//*****************************************************************************
+//
+// Returns the number of samples taken since boot.
+//
+//*****************************************************************************
+uint32_t
+StackMonitorSamplesGet(void)
+{
+    return(g_ui32Samples);
+}
+
+//*****************************************************************************
+//
+// Copies the stack use of up to ui32MaxTasks tasks, in the order they were
+// first seen, and returns the number copied.
+//
+//*****************************************************************************
+uint32_t
+StackMonitorGet(tStackMonitorTask *psTasks, uint32_t ui32MaxTasks)
+{
+    uint32_t ui32Idx;
+
+    taskENTER_CRITICAL();
+    if(ui32MaxTasks > g_ui32NumTasks)
+    {
+        ui32MaxTasks = g_ui32NumTasks;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32MaxTasks; ui32Idx++)
+    {
+        psTasks[ui32Idx] = g_psTasks[ui32Idx];
+    }
+    taskEXIT_CRITICAL();
+
+    return(ui32MaxTasks);
+}
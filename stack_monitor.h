@@ -0,0 +1,95 @@
+//*****************************************************************************
+//
+// stack_monitor.h - Measures the stack used by each task.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __STACK_MONITOR_H__
+#define __STACK_MONITOR_H__
+
+//*****************************************************************************
+//
+// The time between two samples of the tasks' stack high-water marks, in
+// milliseconds.
+//
+//*****************************************************************************
+#define STACK_MONITOR_PERIOD_MS 1000
+
+//*****************************************************************************
+//
+// The share of the peak use added to it when recommending a stack size, in
+// percent.  The recommendation is rounded up to a multiple of
+// STACK_MONITOR_ALIGN words.
+//
+//*****************************************************************************
+#define STACK_MONITOR_MARGIN_PCT                                              \
+                                25
+#define STACK_MONITOR_ALIGN     8
+
+//*****************************************************************************
+//
+// The largest number of tasks tracked.  Tasks are kept by name, so a task
+// that is deleted and created again keeps its peak.
+//
+//*****************************************************************************
+#define STACK_MONITOR_TASKS_MAX 16
+
+//*****************************************************************************
+//
+// The stack use of a task, in words.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The name of the task.
+    //
+    char pcName[configMAX_TASK_NAME_LEN];
+
+    //
+    // The size of the task's stack, or 0 if it is not known.
+    //
+    uint32_t ui32Size;
+
+    //
+    // The least free stack the task has had over all samples.
+    //
+    uint32_t ui32MinFree;
+
+    //
+    // The recommended size of the task's stack: the peak use plus the
+    // margin, or 0 if the size is not known.
+    //
+    uint32_t ui32Recommended;
+}
+tStackMonitorTask;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void StackMonitorSample(void);
+extern uint32_t StackMonitorSamplesGet(void);
+extern uint32_t StackMonitorGet(tStackMonitorTask *psTasks,
+                                uint32_t ui32MaxTasks);
+
+#endif // __STACK_MONITOR_H__
@@ -0,0 +1,338 @@
+//*****************************************************************************
+//
+// status_task.c - A task that displays the IP address and the number of
+//                 tasks whenever they change.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "grlib/grlib.h"
+#include "drivers/glyphcache.h"
+#include "utils/lwiplib.h"
+#include "utils/ustdlib.h"
+#include "lwip_task.h"
+#include "mem_profile.h"
+#include "status_task.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "stack_monitor.h"
+#include "trace.h"
+
+//*****************************************************************************
+//
+// The priority of the status task.  It runs just above the idle task so that
+// the display is only updated when nothing else needs the CPU.
+//
+//*****************************************************************************
+#define STATUS_TASK_PRIORITY    (tskIDLE_PRIORITY + 1)
+
+//*****************************************************************************
+//
+// The stack of the status task, allocated statically; its size is set with
+// the other task stacks in mem_profile.h.
+//
+//*****************************************************************************
+static portSTACK_TYPE g_puxStatusStack[PROFILE_STATUS_STACK_SIZE];
+
+//*****************************************************************************
+//
+// The drawing context, and the mutex that serializes access to it, owned by
+// the application.
+//
+//*****************************************************************************
+extern tContext g_sContext;
+extern xSemaphoreHandle g_sDisplayMutex;
+
+//*****************************************************************************
+//
+// The events that have occurred since the status task last ran, and the
+// semaphore given to wake it.
+//
+//*****************************************************************************
+static volatile uint32_t g_ui32StatusEvents;
+static xSemaphoreHandle g_sStatusSem;
+
+//*****************************************************************************
+//
+// The number of tasks that exist, maintained by the kernel trace hooks.  A
+// deleted task is not freed until the idle task runs, so
+// uxTaskGetNumberOfTasks() does not drop until then.
+//
+//*****************************************************************************
+static volatile uint32_t g_ui32StatusTaskCount;
+
+#if (RUN_HTTP_SERVER)
+//*****************************************************************************
+//
+// Displays the IP address in a human-readable format.
+//
+//*****************************************************************************
+static void
+DisplayIP(uint32_t ui32IP)
+{
+    char pcIPString[24];
+    uint32_t ui32Loop, ui32Idx, ui32Value;
+
+    //
+    // If there is no IP address, indicate that one is being acquired.
+    //
+    if(ui32IP == 0)
+    {
+        GrStringDraw(&g_sContext, "IP address: acquiring...", -1, 50, 50, 1);
+        return;
+    }
+
+    //
+    // Set the initial index into the string that is being constructed.
+    //
+    ui32Idx = 0;
+
+    //
+    // Start the string with four spaces.  Not all will necessarily be used,
+    // depending upon the length of the IP address string.
+    //
+    for(ui32Loop = 0; ui32Loop < 4; ui32Loop++)
+    {
+        pcIPString[ui32Idx++] = ' ';
+    }
+
+    //
+    // Loop through the four bytes of the IP address.
+    //
+    for(ui32Loop = 0; ui32Loop < 32; ui32Loop += 8)
+    {
+        //
+        // Extract this byte from the IP address word.
+        //
+        ui32Value = (ui32IP >> ui32Loop) & 0xff;
+
+        //
+        // Convert this byte into ASCII, using only the characters required.
+        //
+        if(ui32Value > 99)
+        {
+            pcIPString[ui32Idx++] = '0' + (ui32Value / 100);
+        }
+        if(ui32Value > 9)
+        {
+            pcIPString[ui32Idx++] = '0' + ((ui32Value / 10) % 10);
+        }
+        pcIPString[ui32Idx++] = '0' + (ui32Value % 10);
+
+        //
+        // Add a dot to separate this byte from the next.
+        //
+        pcIPString[ui32Idx++] = '.';
+    }
+
+    //
+    // Fill the remainder of the string buffer with spaces.
+    //
+    for(ui32Loop = ui32Idx - 1; ui32Loop < 20; ui32Loop++)
+    {
+        pcIPString[ui32Loop] = ' ';
+    }
+
+    //
+    // Null terminate the string at the appropriate place, based on the length
+    // of the string version of the IP address.  There may or may not be
+    // trailing spaces that remain.
+    //
+    pcIPString[ui32Idx + 3 - ((ui32Idx - 12) / 2)] = '\0';
+
+    //
+    // Display the string.  The horizontal position and the number of leading
+    // spaces utilized depend on the length of the string version of the IP
+    // address.  The end result is the IP address centered in the provided
+    // space with leading/trailing spaces as required to clear the remainder of
+    // the space.
+    //
+    GlyphCacheStringDraw(&g_sContext, pcIPString + ((ui32Idx - 12) / 2), -1,
+                         130, 50);
+}
+#endif
+
+//*****************************************************************************
+//
+// Displays the number of tasks, not counting the idle task.
+//
+//*****************************************************************************
+static void
+DisplayTasks(uint32_t ui32Tasks)
+{
+    char pcBuf[20];
+
+    ustrncpy(pcBuf, "Tasks: ", sizeof(pcBuf));
+    uutoa(pcBuf + 7, ui32Tasks);
+    GlyphCacheStringDraw(&g_sContext, pcBuf, -1, 50, 100);
+}
+
+//*****************************************************************************
+//
+// The status task.  It sleeps until an event is signalled, then redraws the
+// fields that have changed.  Every STACK_MONITOR_PERIOD_MS it also samples
+// the stack use of the tasks, since it runs when nothing else needs the CPU.
+//
+//*****************************************************************************
+static void
+StatusTask(void *pvParameters)
+{
+    uint32_t ui32Events, ui32Value, ui32Tasks, ui32IPAddress;
+    portTickType xSample, xNow, xPeriod;
+
+    ui32Tasks = 0;
+    ui32IPAddress = 0xffffffff;
+    xPeriod = STACK_MONITOR_PERIOD_MS / portTICK_RATE_MS;
+    xSample = xTaskGetTickCount();
+    StackMonitorSample();
+
+    while(1)
+    {
+        //
+        // Wait for something to change or for the next stack sample to be
+        // due.
+        //
+        xNow = xTaskGetTickCount();
+        if((xNow - xSample) >= xPeriod)
+        {
+            xSample = xNow;
+            StackMonitorSample();
+        }
+        if(xSemaphoreTake(g_sStatusSem,
+                          xPeriod - (xNow - xSample)) != pdTRUE)
+        {
+            continue;
+        }
+
+        //
+        // Collect everything that has changed.
+        //
+        taskENTER_CRITICAL();
+        ui32Events = g_ui32StatusEvents;
+        g_ui32StatusEvents = 0;
+        taskEXIT_CRITICAL();
+
+        xSemaphoreTake(g_sDisplayMutex, portMAX_DELAY);
+
+        if(ui32Events & STATUS_EVENT_TASKS)
+        {
+            ui32Value = g_ui32StatusTaskCount - 1;
+            if(ui32Value != ui32Tasks)
+            {
+                ui32Tasks = ui32Value;
+                DisplayTasks(ui32Tasks);
+            }
+        }
+
+#if (RUN_HTTP_SERVER)
+        if(ui32Events & STATUS_EVENT_IP)
+        {
+            ui32Value = lwIPLocalIPAddrGet();
+            if(ui32Value != ui32IPAddress)
+            {
+                ui32IPAddress = ui32Value;
+                DisplayIP(ui32IPAddress);
+            }
+        }
+#else
+        (void)ui32IPAddress;
+#endif
+
+        GrFlush(&g_sContext);
+        xSemaphoreGive(g_sDisplayMutex);
+    }
+}
+
+//*****************************************************************************
+//
+// Signals events to the status task.  This may be called from any task, and
+// from within a critical section.
+//
+//*****************************************************************************
+void
+StatusTaskEvent(uint32_t ui32Events)
+{
+    taskENTER_CRITICAL();
+    g_ui32StatusEvents |= ui32Events;
+    taskEXIT_CRITICAL();
+
+    if(g_sStatusSem)
+    {
+        xSemaphoreGive(g_sStatusSem);
+    }
+}
+
+//*****************************************************************************
+//
+// Called by the kernel, through traceTASK_CREATE, when a task is created.
+//
+//*****************************************************************************
+void
+StatusTaskCreated(void)
+{
+    g_ui32StatusTaskCount++;
+    StatusTaskEvent(STATUS_EVENT_TASKS);
+}
+
+//*****************************************************************************
+//
+// Called by the kernel, through traceTASK_DELETE, when a task is deleted.
+//
+//*****************************************************************************
+void
+StatusTaskDeleted(void)
+{
+    g_ui32StatusTaskCount--;
+    StatusTaskEvent(STATUS_EVENT_TASKS);
+}
+
+//*****************************************************************************
+//
+// Creates the status task.  Returns 0 on success.
+//
+//*****************************************************************************
+uint32_t
+StatusTaskInit(void)
+{
+    vSemaphoreCreateBinary(g_sStatusSem);
+    if(g_sStatusSem == NULL)
+    {
+        return(1);
+    }
+    TraceObjectName(g_sStatusSem, "status");
+
+    //
+    // Draw the initial state once the scheduler starts.
+    //
+    g_ui32StatusEvents = STATUS_EVENT_IP | STATUS_EVENT_TASKS;
+
+    if(xTaskGenericCreate(StatusTask, (signed portCHAR *)"status",
+                          PROFILE_STATUS_STACK_SIZE, NULL,
+                          STATUS_TASK_PRIORITY, NULL, g_puxStatusStack,
+                          NULL) != pdPASS)
+    {
+        return(1);
+    }
+
+    return(0);
+}
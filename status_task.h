@@ -0,0 +1,46 @@
+//*****************************************************************************
+//
+// status_task.h - Prototypes for the system status display task.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+// 
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+// 
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+// 
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __STATUS_TASK_H__
+#define __STATUS_TASK_H__
+
+//*****************************************************************************
+//
+// The events that cause the status task to update the display.
+//
+//*****************************************************************************
+#define STATUS_EVENT_IP         0x00000001
+#define STATUS_EVENT_TASKS      0x00000002
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern uint32_t StatusTaskInit(void);
+extern void StatusTaskEvent(uint32_t ui32Events);
+extern void StatusTaskCreated(void);
+extern void StatusTaskDeleted(void);
+
+#endif // __STATUS_TASK_H__
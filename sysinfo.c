@@ -0,0 +1,1442 @@
+//*****************************************************************************
+//
+// sysinfo.c - System information files for the web server.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "utils/lwipdiag.h"
+#include "utils/ustdlib.h"
+#include "httpd_latency.h"
+#include "cpu_load.h"
+#include "trace.h"
+#include "crash.h"
+#include "fs_gen.h"
+#include "stack_monitor.h"
+#include "sysinfo.h"
+
+//*****************************************************************************
+//
+// The system information files are JSON documents produced a part at a time:
+// an opening part, one part per list element and a closing part.  Each file
+// gathers its information when it is opened and encodes it into the stream
+// buffer one part at a time as the web server asks for data.  The buffer
+// holds the longest part, a /sys/latency phase with every number at its
+// widest, plus the null the number conversions write after each number.
+//
+//*****************************************************************************
+#define SYSINFO_REC_MAX         400
+
+typedef struct _tSysInfoStream
+{
+    //
+    // The encoded part being sent and how much of it is sent.
+    //
+    char pcBuf[SYSINFO_REC_MAX];
+    int iLen;
+    int iPos;
+
+    //
+    // The index of the next part to encode.
+    //
+    uint32_t ui32Part;
+
+    //
+    // Encodes part ui32Part into pcBuf, setting iLen.  Returns false once
+    // there are no more parts.
+    //
+    bool (*pfnEncode)(struct _tSysInfoStream *psStream, uint32_t ui32Part);
+}
+tSysInfoStream;
+
+//*****************************************************************************
+//
+// Text and number writers for the JSON encoders.  Each returns a pointer past
+// the text it wrote.
+//
+//*****************************************************************************
+static char *
+PutText(char *pcBuf, const char *pcText)
+{
+    uint32_t ui32Len = ustrlen(pcText);
+
+    memcpy(pcBuf, pcText, ui32Len);
+    return(pcBuf + ui32Len);
+}
+
+static char *
+PutUInt(char *pcBuf, uint32_t ui32Value)
+{
+    return(pcBuf + uutoa(pcBuf, ui32Value));
+}
+
+static char *
+PutCenti(char *pcBuf, uint32_t ui32Value)
+{
+    return(pcBuf + ufixtoa(pcBuf, (int32_t)ui32Value, 2));
+}
+
+static char *
+PutHex(char *pcBuf, uint32_t ui32Value)
+{
+    return(pcBuf + usprintf(pcBuf, "\"0x%08x\"", ui32Value));
+}
+
+//*****************************************************************************
+//
+// Produces the next part of a system information file.
+//
+//*****************************************************************************
+static int
+SysInfoStreamRead(void *pvState, char *pcBuf, int iCount)
+{
+    tSysInfoStream *psStream = pvState;
+    int iCopied, iLen;
+
+    for(iCopied = 0; iCopied < iCount; iCopied += iLen)
+    {
+        //
+        // Encode the next part once the current one has been sent.
+        //
+        while(psStream->iPos == psStream->iLen)
+        {
+            psStream->iPos = 0;
+            psStream->iLen = 0;
+            if(!psStream->pfnEncode(psStream, psStream->ui32Part))
+            {
+                return((iCopied == 0) ? FS_GEN_EOF : iCopied);
+            }
+            psStream->ui32Part++;
+        }
+
+        iLen = psStream->iLen - psStream->iPos;
+        if(iLen > (iCount - iCopied))
+        {
+            iLen = iCount - iCopied;
+        }
+        memcpy(pcBuf + iCopied, psStream->pcBuf + psStream->iPos, iLen);
+        psStream->iPos += iLen;
+    }
+
+    return(iCopied);
+}
+
+//*****************************************************************************
+//
+// /sys/tasks reports each task's state, priorities, stack high-water mark (the
+// least free stack it has had, in words), its total run time in ticks of the
+// run-time statistics counter and its share of the CPU, in percent, since the
+// previous request.  The first request, or one made after the counter could
+// have wrapped since the previous one, reports the share since boot instead.
+// The interval the shares cover, in counter ticks, is reported along with the
+// counter rate and the CPU load of the last load measurement window:
+//
+// {"uptime":123456,"load":12.34,"rate":1250000,"interval":1250000,
+//  "tasks":[{"name":"IDLE","num":1,"state":"ready","prio":0,"base":0,
+//  "stack":110,"runtime":1234,"cpu":87.66},...]}
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The time the file was opened, in milliseconds since boot, and the CPU
+    // load at that time.
+    //
+    uint32_t ui32Uptime;
+    tCPULoad sLoad;
+
+    //
+    // The interval covered by the shares.
+    //
+    uint32_t ui32Interval;
+
+    //
+    // The tasks and their shares of the CPU, in hundredths of a percent.
+    //
+    uint32_t ui32NumTasks;
+    xTaskStatusType psTasks[SYSINFO_TASKS_MAX];
+    uint16_t pui16Share[SYSINFO_TASKS_MAX];
+}
+tSysInfoTasks;
+
+//*****************************************************************************
+//
+// The run time of each task at the previous /sys/tasks request, from which
+// the shares of the next request are measured.  Files are only opened by the
+// TCP/IP thread, so this needs no lock.
+//
+//*****************************************************************************
+static bool g_bTaskSnapshot;
+static portTickType g_xTaskSnapshotTick;
+static uint32_t g_ui32TaskSnapshotTotal;
+static uint32_t g_ui32TaskSnapshotNum;
+static uint32_t g_pui32TaskSnapshotNumber[SYSINFO_TASKS_MAX];
+static uint32_t g_pui32TaskSnapshotTime[SYSINFO_TASKS_MAX];
+
+//*****************************************************************************
+//
+// The names of the task states, indexed by eTaskState.
+//
+//*****************************************************************************
+static const char * const g_ppcTaskStates[] =
+{
+    "running", "ready", "blocked", "suspended", "deleted"
+};
+
+//*****************************************************************************
+//
+// Returns the run time of a task at the previous request, or 0 if it did not
+// exist then.
+//
+//*****************************************************************************
+static uint32_t
+SysInfoTaskPrevTime(uint32_t ui32Number)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_ui32TaskSnapshotNum; ui32Idx++)
+    {
+        if(g_pui32TaskSnapshotNumber[ui32Idx] == ui32Number)
+        {
+            return(g_pui32TaskSnapshotTime[ui32Idx]);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Encodes a part of /sys/tasks.
+//
+//*****************************************************************************
+static bool
+SysInfoTasksEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoTasks *psTasks = (tSysInfoTasks *)psStream;
+    xTaskStatusType *psTask;
+    char *pcBuf = psStream->pcBuf;
+    uint32_t ui32State;
+
+    if(ui32Part == 0)
+    {
+        pcBuf = PutText(pcBuf, "{\"uptime\":");
+        pcBuf = PutUInt(pcBuf, psTasks->ui32Uptime);
+        pcBuf = PutText(pcBuf, ",\"load\":");
+        pcBuf = PutCenti(pcBuf, psTasks->sLoad.ui32LoadCenti);
+        pcBuf = PutText(pcBuf, ",\"rate\":");
+        pcBuf = PutUInt(pcBuf, CPULoadRunTimeRateGet());
+        pcBuf = PutText(pcBuf, ",\"interval\":");
+        pcBuf = PutUInt(pcBuf, psTasks->ui32Interval);
+        pcBuf = PutText(pcBuf, ",\"tasks\":[");
+    }
+    else if(ui32Part <= psTasks->ui32NumTasks)
+    {
+        psTask = &psTasks->psTasks[ui32Part - 1];
+        ui32State = psTask->eCurrentState;
+        if(ui32State >= (sizeof(g_ppcTaskStates) / sizeof(g_ppcTaskStates[0])))
+        {
+            ui32State = eDeleted;
+        }
+
+        if(ui32Part > 1)
+        {
+            *pcBuf++ = ',';
+        }
+        pcBuf = PutText(pcBuf, "{\"name\":\"");
+        pcBuf = PutText(pcBuf, (const char *)psTask->pcTaskName);
+        pcBuf = PutText(pcBuf, "\",\"num\":");
+        pcBuf = PutUInt(pcBuf, psTask->xTaskNumber);
+        pcBuf = PutText(pcBuf, ",\"state\":\"");
+        pcBuf = PutText(pcBuf, g_ppcTaskStates[ui32State]);
+        pcBuf = PutText(pcBuf, "\",\"prio\":");
+        pcBuf = PutUInt(pcBuf, psTask->uxCurrentPriority);
+        pcBuf = PutText(pcBuf, ",\"base\":");
+        pcBuf = PutUInt(pcBuf, psTask->uxBasePriority);
+        pcBuf = PutText(pcBuf, ",\"stack\":");
+        pcBuf = PutUInt(pcBuf, psTask->usStackHighWaterMark);
+        pcBuf = PutText(pcBuf, ",\"runtime\":");
+        pcBuf = PutUInt(pcBuf, psTask->ulRunTimeCounter);
+        pcBuf = PutText(pcBuf, ",\"cpu\":");
+        pcBuf = PutCenti(pcBuf, psTasks->pui16Share[ui32Part - 1]);
+        *pcBuf++ = '}';
+    }
+    else if(ui32Part == (psTasks->ui32NumTasks + 1))
+    {
+        pcBuf = PutText(pcBuf, "]}");
+    }
+    else
+    {
+        return(false);
+    }
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/tasks, taking a snapshot of the tasks and measuring their shares
+// of the CPU since the previous request.
+//
+//*****************************************************************************
+static void
+SysInfoTasksOpen(void *pvState)
+{
+    tSysInfoTasks *psTasks = pvState;
+    unsigned long ulTotal;
+    portTickType xNow, xMaxAge;
+    uint32_t ui32Idx, ui32Prev, ui32Time;
+
+    psTasks->sStream.pfnEncode = SysInfoTasksEncode;
+
+    psTasks->ui32NumTasks = uxTaskGetSystemState(psTasks->psTasks,
+                                                 SYSINFO_TASKS_MAX, &ulTotal);
+    xNow = xTaskGetTickCount();
+    psTasks->ui32Uptime = xNow * portTICK_RATE_MS;
+    CPULoadGet(&psTasks->sLoad);
+
+    //
+    // Measure from the previous request unless the counter could have
+    // wrapped since.
+    //
+    xMaxAge = ((0xffffffff / CPULoadRunTimeRateGet()) * 1000) /
+              portTICK_RATE_MS;
+    if(!g_bTaskSnapshot || ((xNow - g_xTaskSnapshotTick) >= xMaxAge))
+    {
+        g_ui32TaskSnapshotTotal = 0;
+        g_ui32TaskSnapshotNum = 0;
+    }
+    psTasks->ui32Interval = ulTotal - g_ui32TaskSnapshotTotal;
+
+    for(ui32Idx = 0; ui32Idx < psTasks->ui32NumTasks; ui32Idx++)
+    {
+        ui32Time = psTasks->psTasks[ui32Idx].ulRunTimeCounter;
+        ui32Prev = SysInfoTaskPrevTime(psTasks->psTasks[ui32Idx].xTaskNumber);
+        if((psTasks->ui32Interval == 0) ||
+           ((ui32Time - ui32Prev) > psTasks->ui32Interval))
+        {
+            psTasks->pui16Share[ui32Idx] =
+                (psTasks->ui32Interval == 0) ? 0 : 10000;
+        }
+        else
+        {
+            psTasks->pui16Share[ui32Idx] =
+                (uint16_t)(((uint64_t)(ui32Time - ui32Prev) * 10000) /
+                           psTasks->ui32Interval);
+        }
+    }
+
+    //
+    // Keep this request's run times for the next one.
+    //
+    for(ui32Idx = 0; ui32Idx < psTasks->ui32NumTasks; ui32Idx++)
+    {
+        g_pui32TaskSnapshotNumber[ui32Idx] =
+            psTasks->psTasks[ui32Idx].xTaskNumber;
+        g_pui32TaskSnapshotTime[ui32Idx] =
+            psTasks->psTasks[ui32Idx].ulRunTimeCounter;
+    }
+    g_ui32TaskSnapshotNum = psTasks->ui32NumTasks;
+    g_ui32TaskSnapshotTotal = ulTotal;
+    g_xTaskSnapshotTick = xNow;
+    g_bTaskSnapshot = true;
+}
+
+//*****************************************************************************
+//
+// /sys/stacks reports the peak stack use of each task seen since boot, in
+// words, sampled every STACK_MONITOR_PERIOD_MS by the stack monitor, and the
+// size recommended for its stack: the peak plus a margin of the given percent.
+// "size", "peak" and "recommended" are left out for a task whose stack size is
+// not known.  The sizes and recommendations of the known stacks are totalled:
+//
+// {"uptime":123456,"samples":123,"period":1000,"margin":25,
+//  "tasks":[{"name":"IDLE","size":200,"peak":90,"free":110,
+//  "recommended":120},...],"size":4000,"recommended":2400}
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The time the file was opened, in milliseconds since boot.
+    //
+    uint32_t ui32Uptime;
+
+    //
+    // The number of samples taken and the tasks' stack use.
+    //
+    uint32_t ui32Samples;
+    uint32_t ui32NumTasks;
+    tStackMonitorTask psTasks[STACK_MONITOR_TASKS_MAX];
+}
+tSysInfoStacks;
+
+//*****************************************************************************
+//
+// Encodes a part of /sys/stacks.
+//
+//*****************************************************************************
+static bool
+SysInfoStacksEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoStacks *psStacks = (tSysInfoStacks *)psStream;
+    tStackMonitorTask *psTask;
+    char *pcBuf = psStream->pcBuf;
+    uint32_t ui32Idx, ui32Size, ui32Recommended;
+
+    if(ui32Part == 0)
+    {
+        pcBuf = PutText(pcBuf, "{\"uptime\":");
+        pcBuf = PutUInt(pcBuf, psStacks->ui32Uptime);
+        pcBuf = PutText(pcBuf, ",\"samples\":");
+        pcBuf = PutUInt(pcBuf, psStacks->ui32Samples);
+        pcBuf = PutText(pcBuf, ",\"period\":");
+        pcBuf = PutUInt(pcBuf, STACK_MONITOR_PERIOD_MS);
+        pcBuf = PutText(pcBuf, ",\"margin\":");
+        pcBuf = PutUInt(pcBuf, STACK_MONITOR_MARGIN_PCT);
+        pcBuf = PutText(pcBuf, ",\"tasks\":[");
+    }
+    else if(ui32Part <= psStacks->ui32NumTasks)
+    {
+        psTask = &psStacks->psTasks[ui32Part - 1];
+
+        if(ui32Part > 1)
+        {
+            *pcBuf++ = ',';
+        }
+        pcBuf = PutText(pcBuf, "{\"name\":\"");
+        pcBuf = PutText(pcBuf, psTask->pcName);
+        pcBuf = PutText(pcBuf, "\"");
+        if(psTask->ui32Recommended)
+        {
+            pcBuf = PutText(pcBuf, ",\"size\":");
+            pcBuf = PutUInt(pcBuf, psTask->ui32Size);
+            pcBuf = PutText(pcBuf, ",\"peak\":");
+            pcBuf = PutUInt(pcBuf, psTask->ui32Size - psTask->ui32MinFree);
+        }
+        pcBuf = PutText(pcBuf, ",\"free\":");
+        pcBuf = PutUInt(pcBuf, psTask->ui32MinFree);
+        if(psTask->ui32Recommended)
+        {
+            pcBuf = PutText(pcBuf, ",\"recommended\":");
+            pcBuf = PutUInt(pcBuf, psTask->ui32Recommended);
+        }
+        *pcBuf++ = '}';
+    }
+    else if(ui32Part == (psStacks->ui32NumTasks + 1))
+    {
+        ui32Size = 0;
+        ui32Recommended = 0;
+        for(ui32Idx = 0; ui32Idx < psStacks->ui32NumTasks; ui32Idx++)
+        {
+            psTask = &psStacks->psTasks[ui32Idx];
+            if(psTask->ui32Recommended)
+            {
+                ui32Size += psTask->ui32Size;
+                ui32Recommended += psTask->ui32Recommended;
+            }
+        }
+
+        pcBuf = PutText(pcBuf, "],\"size\":");
+        pcBuf = PutUInt(pcBuf, ui32Size);
+        pcBuf = PutText(pcBuf, ",\"recommended\":");
+        pcBuf = PutUInt(pcBuf, ui32Recommended);
+        *pcBuf++ = '}';
+    }
+    else
+    {
+        return(false);
+    }
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/stacks, taking a snapshot of the stack monitor.
+//
+//*****************************************************************************
+static void
+SysInfoStacksOpen(void *pvState)
+{
+    tSysInfoStacks *psStacks = pvState;
+
+    psStacks->sStream.pfnEncode = SysInfoStacksEncode;
+    psStacks->ui32Uptime = xTaskGetTickCount() * portTICK_RATE_MS;
+    psStacks->ui32Samples = StackMonitorSamplesGet();
+    psStacks->ui32NumTasks = StackMonitorGet(psStacks->psTasks,
+                                             STACK_MONITOR_TASKS_MAX);
+}
+
+//*****************************************************************************
+//
+// Converts timer ticks to microseconds.
+//
+//*****************************************************************************
+static uint32_t
+SysInfoTicksToUS(uint32_t ui32Ticks)
+{
+    return((uint32_t)(((uint64_t)ui32Ticks * 1000000) / CPULoadTimeRateGet()));
+}
+
+//*****************************************************************************
+//
+// Returns the upper bound, in microseconds, of the bucket of a latency
+// histogram holding the given fraction (in hundredths of a percent) of the
+// intervals, but no more than the longest interval.  Bucket n of the
+// histogram counts the intervals shorter than 2^(ui32MinShift + n) ticks not
+// counted by an earlier bucket; the last bucket counts all longer intervals.
+//
+//*****************************************************************************
+static uint32_t
+SysInfoLatencyPercentile(const uint32_t *pui32Hist, uint32_t ui32Buckets,
+                         uint32_t ui32MinShift, uint32_t ui32Count,
+                         uint32_t ui32Max, uint32_t ui32Centi)
+{
+    uint32_t ui32Bucket, ui32Rank, ui32Seen;
+
+    ui32Rank = (uint32_t)((((uint64_t)ui32Count * ui32Centi) + 9999) / 10000);
+    ui32Seen = 0;
+    for(ui32Bucket = 0; ui32Bucket < (ui32Buckets - 1); ui32Bucket++)
+    {
+        ui32Seen += pui32Hist[ui32Bucket];
+        if(ui32Seen >= ui32Rank)
+        {
+            break;
+        }
+    }
+
+    if((ui32Bucket < (ui32Buckets - 1)) &&
+       (((uint32_t)1 << (ui32MinShift + ui32Bucket)) < ui32Max))
+    {
+        ui32Max = (uint32_t)1 << (ui32MinShift + ui32Bucket);
+    }
+
+    return(SysInfoTicksToUS(ui32Max));
+}
+
+//*****************************************************************************
+//
+// Writes the bucket bounds of a latency histogram, in timer ticks, as a JSON
+// array.
+//
+//*****************************************************************************
+static char *
+PutBounds(char *pcBuf, uint32_t ui32Buckets, uint32_t ui32MinShift)
+{
+    uint32_t ui32Idx;
+
+    *pcBuf++ = '[';
+    for(ui32Idx = 0; ui32Idx < (ui32Buckets - 1); ui32Idx++)
+    {
+        if(ui32Idx != 0)
+        {
+            *pcBuf++ = ',';
+        }
+        pcBuf = PutUInt(pcBuf, (uint32_t)1 << (ui32MinShift + ui32Idx));
+    }
+    *pcBuf++ = ']';
+
+    return(pcBuf);
+}
+
+//*****************************************************************************
+//
+// Writes a latency histogram as a JSON object giving the number of intervals,
+// the longest, and the median and 99th percentile in microseconds, followed
+// by the bucket counts.
+//
+//*****************************************************************************
+static char *
+PutLatency(char *pcBuf, const uint32_t *pui32Hist, uint32_t ui32Buckets,
+           uint32_t ui32MinShift, uint32_t ui32Max)
+{
+    uint32_t ui32Idx, ui32Count;
+
+    ui32Count = 0;
+    for(ui32Idx = 0; ui32Idx < ui32Buckets; ui32Idx++)
+    {
+        ui32Count += pui32Hist[ui32Idx];
+    }
+
+    pcBuf = PutText(pcBuf, "{\"n\":");
+    pcBuf = PutUInt(pcBuf, ui32Count);
+    pcBuf = PutText(pcBuf, ",\"max\":");
+    pcBuf = PutUInt(pcBuf, SysInfoTicksToUS(ui32Max));
+    pcBuf = PutText(pcBuf, ",\"p50\":");
+    pcBuf = PutUInt(pcBuf,
+                    SysInfoLatencyPercentile(pui32Hist, ui32Buckets,
+                                             ui32MinShift, ui32Count, ui32Max,
+                                             5000));
+    pcBuf = PutText(pcBuf, ",\"p99\":");
+    pcBuf = PutUInt(pcBuf,
+                    SysInfoLatencyPercentile(pui32Hist, ui32Buckets,
+                                             ui32MinShift, ui32Count, ui32Max,
+                                             9900));
+    pcBuf = PutText(pcBuf, ",\"hist\":[");
+    for(ui32Idx = 0; ui32Idx < ui32Buckets; ui32Idx++)
+    {
+        if(ui32Idx != 0)
+        {
+            *pcBuf++ = ',';
+        }
+        pcBuf = PutUInt(pcBuf, pui32Hist[ui32Idx]);
+    }
+    pcBuf = PutText(pcBuf, "]}");
+
+    return(pcBuf);
+}
+
+#if LWIP_HTTPD_LATENCY
+//*****************************************************************************
+//
+// /sys/latency reports the web server's per-route request latency histograms
+// (see httpd_latency.h).  Bucket n of each histogram counts the intervals
+// shorter than bounds[n] ticks of a timer running at rate Hz and not counted
+// by an earlier bucket; the last bucket counts all longer intervals.  For each
+// phase, the number of intervals, the longest, and the median and 99th
+// percentile are given in microseconds.  The percentiles are the upper bounds
+// of the buckets they fall in, so they overestimate by up to a factor of two:
+//
+// {"rate":80000000,"bounds":[256,512,...],"routes":[{"uri":"/index.html",
+//  "accept":{"n":12,"max":1500,"p50":205,"p99":1677,"hist":[0,...]},
+//  "parse":{...},"handler":{...},"ack":{...},"ack_missed":3},...]}
+//
+// The ack phase is not measured for a response whose connection was closed
+// or reset before it was acknowledged; ack_missed counts these, so a low
+// ack count next to the other phases is not mistaken for a full sample.
+//
+// The histograms are read as the file is sent, so a request served meanwhile
+// may show up in some of the phases of its route and not yet in others.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The routes in use when the file was opened.
+    //
+    uint32_t ui32NumRoutes;
+    uint8_t pui8Routes[HTTPD_LATENCY_ROUTES];
+}
+tSysInfoLatency;
+
+//*****************************************************************************
+//
+// The names of the phases, indexed by enum httpd_latency_phase.
+//
+//*****************************************************************************
+static const char * const g_ppcLatencyPhases[HTTPD_LATENCY_PHASES] =
+{
+    "accept", "parse", "handler", "ack"
+};
+
+//*****************************************************************************
+//
+// Encodes a part of /sys/latency.  After the opening part, each route is sent
+// as one part per phase.
+//
+//*****************************************************************************
+static bool
+SysInfoLatencyEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoLatency *psLatency = (tSysInfoLatency *)psStream;
+    const struct httpd_latency_route *psRoute;
+    char *pcBuf = psStream->pcBuf;
+    uint32_t ui32Route, ui32Phase;
+
+    if(ui32Part == 0)
+    {
+        pcBuf = PutText(pcBuf, "{\"rate\":");
+        pcBuf = PutUInt(pcBuf, CPULoadTimeRateGet());
+        pcBuf = PutText(pcBuf, ",\"bounds\":");
+        pcBuf = PutBounds(pcBuf, HTTPD_LATENCY_BUCKETS,
+                          HTTPD_LATENCY_MIN_SHIFT);
+        pcBuf = PutText(pcBuf, ",\"routes\":[");
+        psStream->iLen = pcBuf - psStream->pcBuf;
+        return(true);
+    }
+
+    ui32Route = (ui32Part - 1) / HTTPD_LATENCY_PHASES;
+    ui32Phase = (ui32Part - 1) % HTTPD_LATENCY_PHASES;
+    if(ui32Route > psLatency->ui32NumRoutes)
+    {
+        return(false);
+    }
+    if(ui32Route == psLatency->ui32NumRoutes)
+    {
+        if(ui32Phase != 0)
+        {
+            return(false);
+        }
+        pcBuf = PutText(pcBuf, "]}");
+        psStream->iLen = pcBuf - psStream->pcBuf;
+        return(true);
+    }
+
+    psRoute = httpd_latency_get(psLatency->pui8Routes[ui32Route]);
+    if(ui32Phase == 0)
+    {
+        if(ui32Route != 0)
+        {
+            *pcBuf++ = ',';
+        }
+        pcBuf = PutText(pcBuf, "{\"uri\":\"");
+        pcBuf = PutText(pcBuf, psRoute->uri);
+        pcBuf = PutText(pcBuf, "\",");
+    }
+    else
+    {
+        *pcBuf++ = ',';
+    }
+
+    *pcBuf++ = '"';
+    pcBuf = PutText(pcBuf, g_ppcLatencyPhases[ui32Phase]);
+    pcBuf = PutText(pcBuf, "\":");
+    pcBuf = PutLatency(pcBuf, psRoute->hist[ui32Phase], HTTPD_LATENCY_BUCKETS,
+                       HTTPD_LATENCY_MIN_SHIFT, psRoute->max[ui32Phase]);
+    if(ui32Phase == (HTTPD_LATENCY_PHASES - 1))
+    {
+        pcBuf = PutText(pcBuf, ",\"ack_missed\":");
+        pcBuf = PutUInt(pcBuf, psRoute->ack_missed);
+        *pcBuf++ = '}';
+    }
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/latency, noting the routes in use.
+//
+//*****************************************************************************
+static void
+SysInfoLatencyOpen(void *pvState)
+{
+    tSysInfoLatency *psLatency = pvState;
+    uint32_t ui32Route;
+
+    psLatency->sStream.pfnEncode = SysInfoLatencyEncode;
+
+    for(ui32Route = 0; ui32Route < HTTPD_LATENCY_ROUTES; ui32Route++)
+    {
+        if(httpd_latency_get(ui32Route) != NULL)
+        {
+            psLatency->pui8Routes[psLatency->ui32NumRoutes++] = ui32Route;
+        }
+    }
+}
+#endif // LWIP_HTTPD_LATENCY
+
+//*****************************************************************************
+//
+// /sys/net reports the network interface's diagnostics (see lwipdiag.h).
+// "input" is the histogram of the time from the Ethernet interrupt reporting
+// a received packet to the packet being passed to the TCP/IP thread, in the
+// form used by /sys/latency, "rx" gives the receive interrupt coalescing
+// counts and "pool" the size of the pbuf pool that packets are received into
+// (the size of each buffer, their number and the memory they take in all).
+//
+// "heap" and "pools" give the size, current use, high-water mark and failed
+// allocations of the lwIP heap (MEM_SIZE, in bytes) and memory pools (in
+// entries); "link", "ip" and "tcp" the packet and error counts of each layer;
+// and "rings" the size, current use, high-water mark and number of times
+// full of the Ethernet DMA descriptor rings:
+//
+// {"rate":80000000,"bounds":[256,512,...],
+//  "input":{"n":1520,"max":35,"p50":6,"p99":12,"hist":[0,...]},
+//  "rx":{"wakeups":1490,"polls":35,"packets":1520,"batches":1488,
+//        "throttled":0,"dropped":0,"retries":0},
+//  "pool":{"bufsize":1536,"count":24,"bytes":37248},
+//  "heap":{"avail":65536,"used":1024,"max":20480,"err":0},
+//  "pools":{"pbuf":{"avail":64,"used":0,"max":12,"err":0},...},
+//  "link":{"xmit":1400,"recv":1520,"drop":0,"chkerr":0,"lenerr":0,
+//          "memerr":0,"rterr":0,"proterr":0,"opterr":0,"err":0},
+//  "ip":{...},"tcp":{...},
+//  "rings":{"tx":{"size":24,"used":0,"max":6,"full":0},"rx":{...}}}
+//
+//*****************************************************************************
+#define SYSINFO_POOL_BYTES      (PBUF_POOL_SIZE *                             \
+                                 (LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) + \
+                                  LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE)))
+
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The diagnostics when the file was opened.
+    //
+    tLwIPLatency sInput;
+    tLwIPRxStats sRx;
+    tLwIPNetStats sStats;
+}
+tSysInfoNet;
+
+//*****************************************************************************
+//
+// The parts of /sys/net: one per memory pool and one per protocol layer
+// follow the fixed parts up to and including the heap.
+//
+//*****************************************************************************
+#define SYSINFO_NET_POOLS       5
+#define SYSINFO_NET_PROTOS      (SYSINFO_NET_POOLS + LWIP_NUM_POOLS)
+#define SYSINFO_NET_RINGS       (SYSINFO_NET_PROTOS + SYSINFO_NET_NUM_PROTOS)
+#define SYSINFO_NET_NUM_PROTOS  3
+
+//*****************************************************************************
+//
+// The names of the memory pools, indexed by LWIP_POOL_*, and of the protocol
+// layers.
+//
+//*****************************************************************************
+static const char * const g_ppcNetPools[LWIP_NUM_POOLS] =
+{
+    "pbuf", "pbuf_pool", "tcp_pcb", "tcp_pcb_listen", "tcp_seg",
+    "sys_timeout", "tcpip_msg_api"
+};
+
+static const char * const g_ppcNetProtos[SYSINFO_NET_NUM_PROTOS] =
+{
+    "link", "ip", "tcp"
+};
+
+//*****************************************************************************
+//
+// Writers for the parts of the network statistics.
+//
+//*****************************************************************************
+static char *
+PutMemStats(char *pcBuf, const tLwIPMemStats *psStats)
+{
+    pcBuf = PutText(pcBuf, "{\"avail\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Avail);
+    pcBuf = PutText(pcBuf, ",\"used\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Used);
+    pcBuf = PutText(pcBuf, ",\"max\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Max);
+    pcBuf = PutText(pcBuf, ",\"err\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Err);
+    *pcBuf++ = '}';
+
+    return(pcBuf);
+}
+
+static char *
+PutProtoStats(char *pcBuf, const tLwIPProtoStats *psStats)
+{
+    pcBuf = PutText(pcBuf, "{\"xmit\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Xmit);
+    pcBuf = PutText(pcBuf, ",\"recv\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Recv);
+    pcBuf = PutText(pcBuf, ",\"drop\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Drop);
+    pcBuf = PutText(pcBuf, ",\"chkerr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32ChkErr);
+    pcBuf = PutText(pcBuf, ",\"lenerr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32LenErr);
+    pcBuf = PutText(pcBuf, ",\"memerr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32MemErr);
+    pcBuf = PutText(pcBuf, ",\"rterr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32RtErr);
+    pcBuf = PutText(pcBuf, ",\"proterr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32ProtErr);
+    pcBuf = PutText(pcBuf, ",\"opterr\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32OptErr);
+    pcBuf = PutText(pcBuf, ",\"err\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Err);
+    *pcBuf++ = '}';
+
+    return(pcBuf);
+}
+
+static char *
+PutRingStats(char *pcBuf, const tLwIPRingStats *psStats)
+{
+    pcBuf = PutText(pcBuf, "{\"size\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Size);
+    pcBuf = PutText(pcBuf, ",\"used\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Used);
+    pcBuf = PutText(pcBuf, ",\"max\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Max);
+    pcBuf = PutText(pcBuf, ",\"full\":");
+    pcBuf = PutUInt(pcBuf, psStats->ui32Full);
+    *pcBuf++ = '}';
+
+    return(pcBuf);
+}
+
+//*****************************************************************************
+//
+// Encodes a part of /sys/net.
+//
+//*****************************************************************************
+static bool
+SysInfoNetEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoNet *psNet = (tSysInfoNet *)psStream;
+    const tLwIPProtoStats *ppsProtos[SYSINFO_NET_NUM_PROTOS];
+    char *pcBuf = psStream->pcBuf;
+    uint32_t ui32Idx;
+
+    if((ui32Part >= SYSINFO_NET_POOLS) && (ui32Part < SYSINFO_NET_PROTOS))
+    {
+        ui32Idx = ui32Part - SYSINFO_NET_POOLS;
+        pcBuf = PutText(pcBuf, (ui32Idx == 0) ? ",\"pools\":{\"" : ",\"");
+        pcBuf = PutText(pcBuf, g_ppcNetPools[ui32Idx]);
+        pcBuf = PutText(pcBuf, "\":");
+        pcBuf = PutMemStats(pcBuf, &psNet->sStats.psPools[ui32Idx]);
+        if(ui32Idx == (LWIP_NUM_POOLS - 1))
+        {
+            *pcBuf++ = '}';
+        }
+        psStream->iLen = pcBuf - psStream->pcBuf;
+        return(true);
+    }
+
+    if((ui32Part >= SYSINFO_NET_PROTOS) && (ui32Part < SYSINFO_NET_RINGS))
+    {
+        ppsProtos[0] = &psNet->sStats.sLink;
+        ppsProtos[1] = &psNet->sStats.sIP;
+        ppsProtos[2] = &psNet->sStats.sTCP;
+
+        ui32Idx = ui32Part - SYSINFO_NET_PROTOS;
+        pcBuf = PutText(pcBuf, ",\"");
+        pcBuf = PutText(pcBuf, g_ppcNetProtos[ui32Idx]);
+        pcBuf = PutText(pcBuf, "\":");
+        pcBuf = PutProtoStats(pcBuf, ppsProtos[ui32Idx]);
+        psStream->iLen = pcBuf - psStream->pcBuf;
+        return(true);
+    }
+
+    switch(ui32Part)
+    {
+        case 0:
+        {
+            pcBuf = PutText(pcBuf, "{\"rate\":");
+            pcBuf = PutUInt(pcBuf, CPULoadTimeRateGet());
+            pcBuf = PutText(pcBuf, ",\"bounds\":");
+            pcBuf = PutBounds(pcBuf, LWIP_LATENCY_BUCKETS,
+                              LWIP_LATENCY_MIN_SHIFT);
+            break;
+        }
+
+        case 1:
+        {
+            pcBuf = PutText(pcBuf, ",\"input\":");
+            pcBuf = PutLatency(pcBuf, psNet->sInput.pui32Hist,
+                               LWIP_LATENCY_BUCKETS, LWIP_LATENCY_MIN_SHIFT,
+                               psNet->sInput.ui32Max);
+            break;
+        }
+
+        case 2:
+        {
+            pcBuf = PutText(pcBuf, ",\"rx\":{\"wakeups\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Wakeups);
+            pcBuf = PutText(pcBuf, ",\"polls\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Polls);
+            pcBuf = PutText(pcBuf, ",\"packets\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Packets);
+            pcBuf = PutText(pcBuf, ",\"batches\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Batches);
+            pcBuf = PutText(pcBuf, ",\"throttled\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Throttled);
+            pcBuf = PutText(pcBuf, ",\"dropped\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Dropped);
+            pcBuf = PutText(pcBuf, ",\"retries\":");
+            pcBuf = PutUInt(pcBuf, psNet->sRx.ui32Retries);
+            *pcBuf++ = '}';
+            break;
+        }
+
+        case 3:
+        {
+            pcBuf = PutText(pcBuf, ",\"pool\":{\"bufsize\":");
+            pcBuf = PutUInt(pcBuf, PBUF_POOL_BUFSIZE);
+            pcBuf = PutText(pcBuf, ",\"count\":");
+            pcBuf = PutUInt(pcBuf, PBUF_POOL_SIZE);
+            pcBuf = PutText(pcBuf, ",\"bytes\":");
+            pcBuf = PutUInt(pcBuf, SYSINFO_POOL_BYTES);
+            *pcBuf++ = '}';
+            break;
+        }
+
+        case 4:
+        {
+            pcBuf = PutText(pcBuf, ",\"heap\":");
+            pcBuf = PutMemStats(pcBuf, &psNet->sStats.sHeap);
+            break;
+        }
+
+        case SYSINFO_NET_RINGS:
+        {
+            pcBuf = PutText(pcBuf, ",\"rings\":{\"tx\":");
+            pcBuf = PutRingStats(pcBuf, &psNet->sStats.sTxRing);
+            pcBuf = PutText(pcBuf, ",\"rx\":");
+            pcBuf = PutRingStats(pcBuf, &psNet->sStats.sRxRing);
+            pcBuf = PutText(pcBuf, "}}");
+            break;
+        }
+
+        default:
+        {
+            return(false);
+        }
+    }
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/net, taking a snapshot of the diagnostics.
+//
+//*****************************************************************************
+static void
+SysInfoNetOpen(void *pvState)
+{
+    tSysInfoNet *psNet = pvState;
+
+    psNet->sStream.pfnEncode = SysInfoNetEncode;
+    lwIPInputLatencyGet(&psNet->sInput);
+    lwIPRxStatsGet(&psNet->sRx);
+    lwIPNetStatsGet(&psNet->sStats);
+}
+
+//*****************************************************************************
+//
+// /sys/crash reports the cause of the last reset (SYSCTL_CAUSE_* flags), the
+// number of crashes recorded since power on and, if there has been one, the
+// last crash; "new" is true if it caused the last reset.  The fault status
+// registers and the registers saved by the processor are only given for a
+// fault, and the latter only if they could be read.  "trace" holds the last
+// events of the trace before the crash, with times in timer ticks (see
+// trace.h):
+//
+// {"reset":"0x00000010","count":1,"new":true,
+//  "crash":{"cause":"fault","uptime":12345,"task":"licznik2","heap":1234},
+//  "fault":{"cfsr":"0x00008200","hfsr":"0x40000000","mmfar":"0x00000000",
+//  "bfar":"0x00000000","sp":"0x20001f00","exc_return":"0xfffffffd"},
+//  "regs":{"r0":"0x00000000",...,"pc":"0x00001234","xpsr":"0x61000000"},
+//  "trace":[{"time":123456,"type":"task_in","data":3},...]}
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The cause of the last reset and the crash record.
+    //
+    uint32_t ui32ResetCause;
+    uint32_t ui32Count;
+    bool bCrash;
+    bool bNew;
+    tCrash sCrash;
+}
+tSysInfoCrash;
+
+//*****************************************************************************
+//
+// The parts of /sys/crash, and the names of the crash causes and of the
+// saved registers.
+//
+//*****************************************************************************
+#define SYSINFO_CRASH_RESET     0
+#define SYSINFO_CRASH_CRASH     1
+#define SYSINFO_CRASH_FAULT     2
+#define SYSINFO_CRASH_REGS      3
+#define SYSINFO_CRASH_TRACE     4
+#define SYSINFO_CRASH_END       (SYSINFO_CRASH_TRACE + CRASH_TRACE_EVENTS)
+
+static const char * const g_ppcCrashCauses[] =
+{
+    "none", "fault", "stack"
+};
+
+static const char * const g_ppcCrashRegs[CRASH_NUM_REGS] =
+{
+    "r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr"
+};
+
+static const char * const g_ppcTraceTypes[] =
+{
+    "none", "task_in", "queue_send", "queue_receive", "isr_enter", "isr_exit"
+};
+
+//*****************************************************************************
+//
+// Returns true if a part of /sys/crash applies to the crash reported.
+//
+//*****************************************************************************
+static bool
+SysInfoCrashPartUsed(tSysInfoCrash *psInfo, uint32_t ui32Part)
+{
+    tCrash *psCrash = &psInfo->sCrash;
+
+    if((ui32Part == SYSINFO_CRASH_RESET) || (ui32Part >= SYSINFO_CRASH_END))
+    {
+        return(true);
+    }
+    if(!psInfo->bCrash)
+    {
+        return(false);
+    }
+    if(ui32Part == SYSINFO_CRASH_FAULT)
+    {
+        return(psCrash->ui32Cause == CRASH_CAUSE_FAULT);
+    }
+    if(ui32Part == SYSINFO_CRASH_REGS)
+    {
+        return((psCrash->ui32Cause == CRASH_CAUSE_FAULT) &&
+               (psCrash->ui32Flags & CRASH_FLAG_FRAME));
+    }
+    if(ui32Part >= SYSINFO_CRASH_TRACE)
+    {
+        return((ui32Part - SYSINFO_CRASH_TRACE) < psCrash->ui32TraceCount);
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Encodes a part of /sys/crash.
+//
+//*****************************************************************************
+static bool
+SysInfoCrashEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoCrash *psInfo = (tSysInfoCrash *)psStream;
+    tCrash *psCrash = &psInfo->sCrash;
+    tTraceEvent *psEvent;
+    char *pcBuf = psStream->pcBuf;
+    uint32_t ui32Idx;
+
+    //
+    // Skip the parts that do not apply to this crash.
+    //
+    while(!SysInfoCrashPartUsed(psInfo, ui32Part))
+    {
+        ui32Part++;
+    }
+    psStream->ui32Part = ui32Part;
+
+    if((ui32Part >= SYSINFO_CRASH_TRACE) && (ui32Part < SYSINFO_CRASH_END))
+    {
+        psEvent = &psCrash->psTrace[ui32Part - SYSINFO_CRASH_TRACE];
+        ui32Idx = psEvent->ui8Type;
+        if(ui32Idx >= (sizeof(g_ppcTraceTypes) / sizeof(g_ppcTraceTypes[0])))
+        {
+            ui32Idx = 0;
+        }
+
+        pcBuf = PutText(pcBuf, (ui32Part == SYSINFO_CRASH_TRACE) ?
+                               ",\"trace\":[{\"time\":" : ",{\"time\":");
+        pcBuf = PutUInt(pcBuf, psEvent->ui32Time);
+        pcBuf = PutText(pcBuf, ",\"type\":\"");
+        pcBuf = PutText(pcBuf, g_ppcTraceTypes[ui32Idx]);
+        pcBuf = PutText(pcBuf, "\",\"data\":");
+        pcBuf = PutUInt(pcBuf, psEvent->ui16Data);
+        *pcBuf++ = '}';
+        if((ui32Part - SYSINFO_CRASH_TRACE + 1) == psCrash->ui32TraceCount)
+        {
+            *pcBuf++ = ']';
+        }
+    }
+    else
+    {
+        switch(ui32Part)
+        {
+            case SYSINFO_CRASH_RESET:
+            {
+                pcBuf = PutText(pcBuf, "{\"reset\":");
+                pcBuf = PutHex(pcBuf, psInfo->ui32ResetCause);
+                pcBuf = PutText(pcBuf, ",\"count\":");
+                pcBuf = PutUInt(pcBuf, psInfo->ui32Count);
+                if(psInfo->bCrash)
+                {
+                    pcBuf = PutText(pcBuf, psInfo->bNew ? ",\"new\":true" :
+                                                          ",\"new\":false");
+                }
+                break;
+            }
+
+            case SYSINFO_CRASH_CRASH:
+            {
+                ui32Idx = psCrash->ui32Cause;
+                if(ui32Idx >= (sizeof(g_ppcCrashCauses) /
+                               sizeof(g_ppcCrashCauses[0])))
+                {
+                    ui32Idx = CRASH_CAUSE_NONE;
+                }
+
+                pcBuf = PutText(pcBuf, ",\"crash\":{\"cause\":\"");
+                pcBuf = PutText(pcBuf, g_ppcCrashCauses[ui32Idx]);
+                pcBuf = PutText(pcBuf, "\",\"uptime\":");
+                pcBuf = PutUInt(pcBuf, psCrash->ui32Uptime);
+                pcBuf = PutText(pcBuf, ",\"task\":\"");
+                pcBuf = PutText(pcBuf, psCrash->pcTask);
+                pcBuf = PutText(pcBuf, "\",\"heap\":");
+                pcBuf = PutUInt(pcBuf, psCrash->ui32HeapFree);
+                *pcBuf++ = '}';
+                break;
+            }
+
+            case SYSINFO_CRASH_FAULT:
+            {
+                pcBuf = PutText(pcBuf, ",\"fault\":{\"cfsr\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32CFSR);
+                pcBuf = PutText(pcBuf, ",\"hfsr\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32HFSR);
+                pcBuf = PutText(pcBuf, ",\"mmfar\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32MMFAR);
+                pcBuf = PutText(pcBuf, ",\"bfar\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32BFAR);
+                pcBuf = PutText(pcBuf, ",\"sp\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32SP);
+                pcBuf = PutText(pcBuf, ",\"exc_return\":");
+                pcBuf = PutHex(pcBuf, psCrash->ui32ExcReturn);
+                *pcBuf++ = '}';
+                break;
+            }
+
+            case SYSINFO_CRASH_REGS:
+            {
+                pcBuf = PutText(pcBuf, ",\"regs\":{");
+                for(ui32Idx = 0; ui32Idx < CRASH_NUM_REGS; ui32Idx++)
+                {
+                    if(ui32Idx)
+                    {
+                        *pcBuf++ = ',';
+                    }
+                    *pcBuf++ = '"';
+                    pcBuf = PutText(pcBuf, g_ppcCrashRegs[ui32Idx]);
+                    pcBuf = PutText(pcBuf, "\":");
+                    pcBuf = PutHex(pcBuf, psCrash->pui32Frame[ui32Idx]);
+                }
+                *pcBuf++ = '}';
+                break;
+            }
+
+            case SYSINFO_CRASH_END:
+            {
+                *pcBuf++ = '}';
+                break;
+            }
+
+            default:
+            {
+                return(false);
+            }
+        }
+    }
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/crash.
+//
+//*****************************************************************************
+static void
+SysInfoCrashOpen(void *pvState)
+{
+    tSysInfoCrash *psInfo = pvState;
+
+    psInfo->sStream.pfnEncode = SysInfoCrashEncode;
+    psInfo->ui32ResetCause = CrashResetCauseGet();
+    psInfo->bCrash = CrashGet(&psInfo->sCrash, &psInfo->ui32Count,
+                              &psInfo->bNew);
+}
+
+#ifdef USTDLIB_BENCHMARK
+//*****************************************************************************
+//
+// /sys/fmtbench runs ufmtbenchmark() when opened and reports the timer ticks
+// (see "rate") taken to format SYSINFO_FMTBENCH_ITERATIONS values with each
+// method: as integers with uitoa() and usprintf(), and in tenths with
+// ufixtoa() and usprintf().  The benchmark runs on the TCP/IP thread, so
+// other connections stall for its duration:
+//
+// {"rate":80000000,"iterations":256,"uitoa":12345,"usprintf_int":23456,
+//  "ufixtoa":13456,"usprintf_fix":45678}
+//
+//*****************************************************************************
+#define SYSINFO_FMTBENCH_ITERATIONS 256
+
+typedef struct
+{
+    //
+    // The stream; must be first.
+    //
+    tSysInfoStream sStream;
+
+    //
+    // The result of the benchmark.
+    //
+    tUFmtBenchmark sResult;
+}
+tSysInfoFmtBench;
+
+//*****************************************************************************
+//
+// Encodes /sys/fmtbench.
+//
+//*****************************************************************************
+static bool
+SysInfoFmtBenchEncode(tSysInfoStream *psStream, uint32_t ui32Part)
+{
+    tSysInfoFmtBench *psInfo = (tSysInfoFmtBench *)psStream;
+    char *pcBuf = psStream->pcBuf;
+
+    if(ui32Part != 0)
+    {
+        return(false);
+    }
+
+    pcBuf = PutText(pcBuf, "{\"rate\":");
+    pcBuf = PutUInt(pcBuf, CPULoadTimeRateGet());
+    pcBuf = PutText(pcBuf, ",\"iterations\":");
+    pcBuf = PutUInt(pcBuf, SYSINFO_FMTBENCH_ITERATIONS);
+    pcBuf = PutText(pcBuf, ",\"uitoa\":");
+    pcBuf = PutUInt(pcBuf, psInfo->sResult.ui32IntFast);
+    pcBuf = PutText(pcBuf, ",\"usprintf_int\":");
+    pcBuf = PutUInt(pcBuf, psInfo->sResult.ui32IntPrintf);
+    pcBuf = PutText(pcBuf, ",\"ufixtoa\":");
+    pcBuf = PutUInt(pcBuf, psInfo->sResult.ui32FixFast);
+    pcBuf = PutText(pcBuf, ",\"usprintf_fix\":");
+    pcBuf = PutUInt(pcBuf, psInfo->sResult.ui32FixPrintf);
+    *pcBuf++ = '}';
+
+    psStream->iLen = pcBuf - psStream->pcBuf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/fmtbench, running the benchmark.
+//
+//*****************************************************************************
+static void
+SysInfoFmtBenchOpen(void *pvState)
+{
+    tSysInfoFmtBench *psInfo = pvState;
+
+    psInfo->sStream.pfnEncode = SysInfoFmtBenchEncode;
+    ufmtbenchmark(CPULoadTimeGet, SYSINFO_FMTBENCH_ITERATIONS,
+                  &psInfo->sResult);
+}
+#endif
+
+//*****************************************************************************
+//
+// The system information files.
+//
+//*****************************************************************************
+static const tFSGenerator g_psSysInfoFiles[] =
+{
+    {
+        "/sys/tasks", sizeof(tSysInfoTasks), SysInfoTasksOpen,
+        SysInfoStreamRead
+    },
+    {
+        "/sys/stacks", sizeof(tSysInfoStacks), SysInfoStacksOpen,
+        SysInfoStreamRead
+    },
+#if LWIP_HTTPD_LATENCY
+    {
+        "/sys/latency", sizeof(tSysInfoLatency), SysInfoLatencyOpen,
+        SysInfoStreamRead
+    },
+#endif
+    {
+        "/sys/net", sizeof(tSysInfoNet), SysInfoNetOpen, SysInfoStreamRead
+    },
+    {
+        "/sys/crash", sizeof(tSysInfoCrash), SysInfoCrashOpen,
+        SysInfoStreamRead
+    },
+#ifdef USTDLIB_BENCHMARK
+    {
+        "/sys/fmtbench", sizeof(tSysInfoFmtBench), SysInfoFmtBenchOpen,
+        SysInfoStreamRead
+    },
+#endif
+};
+
+#define NUM_SYSINFO_FILES       (sizeof(g_psSysInfoFiles) /                  \
+                                 sizeof(g_psSysInfoFiles[0]))
+
+//*****************************************************************************
+//
+// Registers the system information files with the web server file system.
+//
+//*****************************************************************************
+void
+SysInfoFilesRegister(void)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < NUM_SYSINFO_FILES; ui32Idx++)
+    {
+        FSGenRegister(&g_psSysInfoFiles[ui32Idx]);
+    }
+}
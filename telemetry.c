@@ -0,0 +1,701 @@
+//*****************************************************************************
+//
+// telemetry.c - Sensor sample store and its binary representation.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "utils/ustdlib.h"
+#include "fs_gen.h"
+#include "telemetry.h"
+#include "trace.h"
+
+//*****************************************************************************
+//
+// The current measurements are published through two copies of the snapshot
+// and a sequence number.  The writer fills in the copy that readers are not
+// directed to and then advances the sequence number, which selects the copy
+// to read.  A reader copies the snapshot selected by the sequence number and
+// retries if the number changed meanwhile, so readers never take a lock, make
+// a kernel call or mask interrupts, and a reader that preempts the writer is
+// never left waiting for it.
+//
+// The history is indexed by sequence number modulo its length.  The writer
+// clears the sequence number of a slot while updating it, so a reader can
+// tell a slot that changed while it was copied.
+//
+// Writers (the time and temperature tasks) are serialized by a mutex.  Each
+// update gives a binary semaphore that a consumer, such as the display, can
+// block on; updates made before it wakes up are coalesced into one.
+//
+//*****************************************************************************
+static volatile uint32_t g_ui32SnapshotSeq;
+static volatile tTelemetrySample g_psSnapshot[2];
+static volatile tTelemetrySample g_psHistory[TELEMETRY_HISTORY_LEN];
+static xSemaphoreHandle g_sWriteMutex;
+static xSemaphoreHandle g_sUpdateSem;
+
+//*****************************************************************************
+//
+// Copies a sample out of, or into, shared memory.
+//
+//*****************************************************************************
+static void
+TelemetryCopyOut(tTelemetrySample *psDst, const volatile tTelemetrySample *psSrc)
+{
+    psDst->ui32Seq = psSrc->ui32Seq;
+    psDst->ui32TimeMS = psSrc->ui32TimeMS;
+    psDst->i32Time = psSrc->i32Time;
+    psDst->i32TempCenti = psSrc->i32TempCenti;
+}
+
+static void
+TelemetryCopyIn(volatile tTelemetrySample *psDst, const tTelemetrySample *psSrc)
+{
+    psDst->ui32Seq = psSrc->ui32Seq;
+    psDst->ui32TimeMS = psSrc->ui32TimeMS;
+    psDst->i32Time = psSrc->i32Time;
+    psDst->i32TempCenti = psSrc->i32TempCenti;
+}
+
+//*****************************************************************************
+//
+// Publishes a new snapshot.  Must be called with the write mutex held.
+//
+//*****************************************************************************
+static void
+TelemetryPublish(const tTelemetrySample *psSample)
+{
+    uint32_t ui32Seq = g_ui32SnapshotSeq;
+
+    TelemetryCopyIn(&g_psSnapshot[(ui32Seq + 1) & 1], psSample);
+    g_ui32SnapshotSeq = ui32Seq + 1;
+
+    xSemaphoreGive(g_sUpdateSem);
+}
+
+//*****************************************************************************
+//
+// Initializes the telemetry store.  Must be called before the tasks that
+// record measurements are started.
+//
+//*****************************************************************************
+void
+TelemetryInit(void)
+{
+    g_sWriteMutex = xSemaphoreCreateMutex();
+
+    //
+    // The semaphore is created given, so the first wait returns at once and
+    // the consumer shows the initial values.
+    //
+    vSemaphoreCreateBinary(g_sUpdateSem);
+
+    TraceObjectName(g_sWriteMutex, "telem_write");
+    TraceObjectName(g_sUpdateSem, "telem_update");
+}
+
+//*****************************************************************************
+//
+// Waits until the measurements have changed since the last call, or for
+// ui32Ticks ticks (portMAX_DELAY to wait forever).  Returns true if they have
+// changed.  Only one task may wait for updates.
+//
+//*****************************************************************************
+bool
+TelemetryWaitUpdate(uint32_t ui32Ticks)
+{
+    return(xSemaphoreTake(g_sUpdateSem, (portTickType)ui32Ticks) == pdTRUE);
+}
+
+//*****************************************************************************
+//
+// Records a new value of the time counter.  It is published at once and
+// stored in the history with the next temperature sample.
+//
+//*****************************************************************************
+void
+TelemetryTimeSet(int32_t i32Time)
+{
+    tTelemetrySample sSample;
+
+    xSemaphoreTake(g_sWriteMutex, portMAX_DELAY);
+    TelemetryCopyOut(&sSample, &g_psSnapshot[g_ui32SnapshotSeq & 1]);
+    sSample.i32Time = i32Time;
+    TelemetryPublish(&sSample);
+    xSemaphoreGive(g_sWriteMutex);
+}
+
+//*****************************************************************************
+//
+// Records a new temperature reading as the next sample.
+//
+//*****************************************************************************
+void
+TelemetryTemperatureSet(float fTemperature)
+{
+    volatile tTelemetrySample *psSlot;
+    tTelemetrySample sSample;
+    uint32_t ui32Seq;
+
+    xSemaphoreTake(g_sWriteMutex, portMAX_DELAY);
+    TelemetryCopyOut(&sSample, &g_psSnapshot[g_ui32SnapshotSeq & 1]);
+
+    //
+    // Round to hundredths of a degree.
+    //
+    sSample.i32TempCenti = (int32_t)((fTemperature * 100.0f) +
+                                     ((fTemperature < 0) ? -0.5f : 0.5f));
+    sSample.ui32TimeMS = xTaskGetTickCount() * portTICK_RATE_MS;
+    ui32Seq = sSample.ui32Seq + 1;
+
+    //
+    // Store the sample in the history, marking the slot as being updated
+    // until it is complete.
+    //
+    psSlot = &g_psHistory[ui32Seq % TELEMETRY_HISTORY_LEN];
+    psSlot->ui32Seq = 0;
+    sSample.ui32Seq = 0;
+    TelemetryCopyIn(psSlot, &sSample);
+    psSlot->ui32Seq = ui32Seq;
+
+    sSample.ui32Seq = ui32Seq;
+    TelemetryPublish(&sSample);
+    xSemaphoreGive(g_sWriteMutex);
+}
+
+//*****************************************************************************
+//
+// Returns a consistent snapshot of the current measurements: the latest
+// sample, with the time counter as last recorded.  Its sequence number is 0
+// if no sample has been taken yet.  This may be called from any task.
+//
+//*****************************************************************************
+void
+TelemetrySampleGet(tTelemetrySample *psSample)
+{
+    uint32_t ui32Seq;
+
+    do
+    {
+        ui32Seq = g_ui32SnapshotSeq;
+        TelemetryCopyOut(psSample, &g_psSnapshot[ui32Seq & 1]);
+    }
+    while(ui32Seq != g_ui32SnapshotSeq);
+}
+
+//*****************************************************************************
+//
+// Returns the sample in the history slot of the given sequence number.
+// Returns false if that is not the requested sample because it is not yet,
+// or no longer, in the history, or is being updated.
+//
+//*****************************************************************************
+bool
+TelemetryHistoryGet(uint32_t ui32Seq, tTelemetrySample *psSample)
+{
+    volatile tTelemetrySample *psSlot;
+    uint32_t ui32SlotSeq;
+
+    psSlot = &g_psHistory[ui32Seq % TELEMETRY_HISTORY_LEN];
+    do
+    {
+        ui32SlotSeq = psSlot->ui32Seq;
+        TelemetryCopyOut(psSample, psSlot);
+    }
+    while(ui32SlotSeq != psSlot->ui32Seq);
+
+    return((ui32Seq != 0) && (ui32SlotSeq == ui32Seq));
+}
+
+//*****************************************************************************
+//
+// Returns the sequence number of the oldest sample in the history and the
+// number of samples in it.
+//
+//*****************************************************************************
+void
+TelemetryHistoryRange(uint32_t *pui32First, uint32_t *pui32Count)
+{
+    tTelemetrySample sSample;
+    uint32_t ui32Last;
+
+    TelemetrySampleGet(&sSample);
+    ui32Last = sSample.ui32Seq;
+
+    *pui32Count = (ui32Last < TELEMETRY_HISTORY_LEN) ? ui32Last :
+                                                       TELEMETRY_HISTORY_LEN;
+    *pui32First = ui32Last - *pui32Count + 1;
+}
+
+//*****************************************************************************
+//
+// Little-endian field writers for the binary format.
+//
+//*****************************************************************************
+static uint8_t *
+Put16(uint8_t *pui8Buf, uint32_t ui32Val)
+{
+    pui8Buf[0] = (uint8_t)ui32Val;
+    pui8Buf[1] = (uint8_t)(ui32Val >> 8);
+    return(pui8Buf + 2);
+}
+
+static uint8_t *
+Put32(uint8_t *pui8Buf, uint32_t ui32Val)
+{
+    pui8Buf[0] = (uint8_t)ui32Val;
+    pui8Buf[1] = (uint8_t)(ui32Val >> 8);
+    pui8Buf[2] = (uint8_t)(ui32Val >> 16);
+    pui8Buf[3] = (uint8_t)(ui32Val >> 24);
+    return(pui8Buf + 4);
+}
+
+//*****************************************************************************
+//
+// The text formats are produced from templates: constant text segments, each
+// followed by a sample field.  Only the fields are formatted per request, with
+// the format-free number conversions from ustdlib; the text, including its
+// length, is fixed at compile time.
+//
+//*****************************************************************************
+#define FIELD_NONE              0
+#define FIELD_SEQ               1
+#define FIELD_TIMESTAMP         2
+#define FIELD_TIME              3
+#define FIELD_TEMP_CENTI        4
+#define FIELD_TEMP_TENTHS       5
+
+typedef struct
+{
+    const char *pcText;
+    uint8_t ui8TextLen;
+    uint8_t ui8Field;
+}
+tTelemetrySegment;
+
+#define SEGMENT(text, field)    { text, sizeof(text) - 1, field }
+
+//
+// The sample as a JSON object.
+//
+static const tTelemetrySegment g_psJSONSample[] =
+{
+    SEGMENT("{\"seq\":", FIELD_SEQ),
+    SEGMENT(",\"ts\":", FIELD_TIMESTAMP),
+    SEGMENT(",\"time\":", FIELD_TIME),
+    SEGMENT(",\"temperature\":", FIELD_TEMP_CENTI),
+    SEGMENT("}", FIELD_NONE)
+};
+
+//
+// The sample as read by the web page from /dataread.
+//
+static const tTelemetrySegment g_psFormSample[] =
+{
+    SEGMENT("time=", FIELD_TIME),
+    SEGMENT("&temperature=", FIELD_TEMP_TENTHS)
+};
+
+//
+// The text around the samples of /history.json.
+//
+static const char g_pcJSONHistoryStart[] = "{\"version\":1,\"samples\":[";
+static const char g_pcJSONHistoryEnd[] = "]}";
+
+//*****************************************************************************
+//
+// The longest record produced by any of the formats: a JSON sample with a
+// leading comma and every field at its widest, plus the null the number
+// conversions write after each field.
+//
+//*****************************************************************************
+#define TELEMETRY_REC_MAX       96
+
+//*****************************************************************************
+//
+// Fills in a template for a sample.  Returns the number of characters written.
+//
+//*****************************************************************************
+static int
+TelemetryTemplateFill(char *pcBuf, const tTelemetrySegment *psSegments,
+                      uint32_t ui32NumSegments,
+                      const tTelemetrySample *psSample)
+{
+    uint32_t ui32Idx;
+    int iLen;
+
+    iLen = 0;
+    for(ui32Idx = 0; ui32Idx < ui32NumSegments; ui32Idx++)
+    {
+        memcpy(pcBuf + iLen, psSegments[ui32Idx].pcText,
+               psSegments[ui32Idx].ui8TextLen);
+        iLen += psSegments[ui32Idx].ui8TextLen;
+
+        switch(psSegments[ui32Idx].ui8Field)
+        {
+            case FIELD_SEQ:
+                iLen += uutoa(pcBuf + iLen, psSample->ui32Seq);
+                break;
+            case FIELD_TIMESTAMP:
+                iLen += uutoa(pcBuf + iLen, psSample->ui32TimeMS);
+                break;
+            case FIELD_TIME:
+                iLen += uitoa(pcBuf + iLen, psSample->i32Time);
+                break;
+            case FIELD_TEMP_CENTI:
+                iLen += ufixtoa(pcBuf + iLen, psSample->i32TempCenti, 2);
+                break;
+            case FIELD_TEMP_TENTHS:
+                iLen += ufixtoa(pcBuf + iLen,
+                                TELEMETRY_CENTI_TO_TENTHS(
+                                    psSample->i32TempCenti), 1);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return(iLen);
+}
+
+//*****************************************************************************
+//
+// The formats of the telemetry files.
+//
+//*****************************************************************************
+#define TELEMETRY_FMT_BIN       0
+#define TELEMETRY_FMT_JSON      1
+#define TELEMETRY_FMT_FORM      2
+
+//*****************************************************************************
+//
+// The state of an open telemetry file.  The file header, each record and the
+// file trailer are encoded into pcBuf in turn and copied out as the web
+// server asks for data, so the file never has to be held in memory as a
+// whole.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The encoded part being sent and how much of it is sent.
+    //
+    char pcBuf[TELEMETRY_REC_MAX];
+    int iLen;
+    int iPos;
+
+    //
+    // The sequence number of the next record and the number of records still
+    // to encode.
+    //
+    uint32_t ui32Seq;
+    uint32_t ui32Left;
+
+    //
+    // The snapshot sent by the files holding the latest sample.
+    //
+    tTelemetrySample sLatest;
+
+    //
+    // The format, whether this is the history (a list of samples), whether
+    // the next sample must be preceded by a separator and whether the
+    // trailer has been encoded.
+    //
+    uint8_t ui8Format;
+    bool bHistory;
+    bool bSeparate;
+    bool bDone;
+}
+tTelemetryStream;
+
+//*****************************************************************************
+//
+// Sets up a stream of ui32Count samples, starting at ui32Seq, and encodes
+// the file header.
+//
+//*****************************************************************************
+static void
+TelemetryStreamOpen(tTelemetryStream *psStream, uint8_t ui8Format,
+                    bool bHistory, uint32_t ui32Seq, uint32_t ui32Count)
+{
+    uint8_t *pui8Buf = (uint8_t *)psStream->pcBuf;
+
+    psStream->ui8Format = ui8Format;
+    psStream->bHistory = bHistory;
+    psStream->ui32Seq = ui32Seq;
+    psStream->ui32Left = ui32Count;
+    psStream->iPos = 0;
+    psStream->iLen = 0;
+
+    if(ui8Format == TELEMETRY_FMT_BIN)
+    {
+        *pui8Buf++ = 'T';
+        *pui8Buf++ = 'M';
+        *pui8Buf++ = TELEMETRY_BIN_VERSION;
+        *pui8Buf++ = TELEMETRY_BIN_REC_SIZE;
+        pui8Buf = Put16(pui8Buf, ui32Count);
+        Put16(pui8Buf, 0);
+        psStream->iLen = TELEMETRY_BIN_HDR_SIZE;
+    }
+    else if((ui8Format == TELEMETRY_FMT_JSON) && bHistory)
+    {
+        psStream->iLen = sizeof(g_pcJSONHistoryStart) - 1;
+        memcpy(psStream->pcBuf, g_pcJSONHistoryStart, psStream->iLen);
+    }
+}
+
+//*****************************************************************************
+//
+// Encodes the next record, or the trailer after the last one.  Returns false
+// once there is nothing left to encode.
+//
+//*****************************************************************************
+static bool
+TelemetryStreamNext(tTelemetryStream *psStream)
+{
+    tTelemetrySample sSample;
+    uint8_t *pui8Buf;
+    char *pcBuf;
+
+    psStream->iPos = 0;
+    psStream->iLen = 0;
+
+    if(psStream->ui32Left == 0)
+    {
+        if(psStream->bDone)
+        {
+            return(false);
+        }
+        psStream->bDone = true;
+        if((psStream->ui8Format == TELEMETRY_FMT_JSON) && psStream->bHistory)
+        {
+            psStream->iLen = sizeof(g_pcJSONHistoryEnd) - 1;
+            memcpy(psStream->pcBuf, g_pcJSONHistoryEnd, psStream->iLen);
+        }
+        return(true);
+    }
+
+    //
+    // A history record overwritten since the file was opened is sent as the
+    // newer sample now in its slot, and one being updated as it is read with
+    // sequence number 0; clients can tell from the sequence number.
+    //
+    if(psStream->bHistory)
+    {
+        TelemetryHistoryGet(psStream->ui32Seq, &sSample);
+    }
+    else
+    {
+        sSample = psStream->sLatest;
+    }
+    psStream->ui32Seq++;
+    psStream->ui32Left--;
+
+    switch(psStream->ui8Format)
+    {
+        case TELEMETRY_FMT_BIN:
+        {
+            pui8Buf = (uint8_t *)psStream->pcBuf;
+            pui8Buf = Put32(pui8Buf, sSample.ui32Seq);
+            pui8Buf = Put32(pui8Buf, sSample.ui32TimeMS);
+            pui8Buf = Put32(pui8Buf, (uint32_t)sSample.i32Time);
+            pui8Buf = Put16(pui8Buf, (uint32_t)sSample.i32TempCenti);
+            Put16(pui8Buf, 0);
+            psStream->iLen = TELEMETRY_BIN_REC_SIZE;
+            break;
+        }
+
+        case TELEMETRY_FMT_JSON:
+        {
+            pcBuf = psStream->pcBuf;
+            if(psStream->bSeparate)
+            {
+                *pcBuf++ = ',';
+            }
+            psStream->bSeparate = psStream->bHistory;
+            psStream->iLen = (pcBuf - psStream->pcBuf) +
+                             TelemetryTemplateFill(pcBuf, g_psJSONSample,
+                                                   sizeof(g_psJSONSample) /
+                                                   sizeof(g_psJSONSample[0]),
+                                                   &sSample);
+            break;
+        }
+
+        case TELEMETRY_FMT_FORM:
+        {
+            psStream->iLen = TelemetryTemplateFill(psStream->pcBuf,
+                                                   g_psFormSample,
+                                                   sizeof(g_psFormSample) /
+                                                   sizeof(g_psFormSample[0]),
+                                                   &sSample);
+            break;
+        }
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Produces the next part of a telemetry file.
+//
+//*****************************************************************************
+static int
+TelemetryStreamRead(void *pvState, char *pcBuf, int iCount)
+{
+    tTelemetryStream *psStream = pvState;
+    int iCopied, iLen;
+
+    for(iCopied = 0; iCopied < iCount; iCopied += iLen)
+    {
+        //
+        // Encode the next part once the current one has been sent.
+        //
+        while(psStream->iPos == psStream->iLen)
+        {
+            if(!TelemetryStreamNext(psStream))
+            {
+                return((iCopied == 0) ? FS_GEN_EOF : iCopied);
+            }
+        }
+
+        iLen = psStream->iLen - psStream->iPos;
+        if(iLen > (iCount - iCopied))
+        {
+            iLen = iCount - iCopied;
+        }
+        memcpy(pcBuf + iCopied, psStream->pcBuf + psStream->iPos, iLen);
+        psStream->iPos += iLen;
+    }
+
+    return(iCopied);
+}
+
+//*****************************************************************************
+//
+// Opens a file holding the latest sample.
+//
+//*****************************************************************************
+static void
+TelemetryLatestOpen(tTelemetryStream *psStream, uint8_t ui8Format)
+{
+    TelemetrySampleGet(&psStream->sLatest);
+    TelemetryStreamOpen(psStream, ui8Format, false, psStream->sLatest.ui32Seq,
+                        1);
+}
+
+//*****************************************************************************
+//
+// Opens a file holding every sample in the history, oldest first.
+//
+//*****************************************************************************
+static void
+TelemetryHistoryOpen(tTelemetryStream *psStream, uint8_t ui8Format)
+{
+    uint32_t ui32First, ui32Count;
+
+    TelemetryHistoryRange(&ui32First, &ui32Count);
+    TelemetryStreamOpen(psStream, ui8Format, true, ui32First, ui32Count);
+}
+
+static void
+TelemetryDataReadOpen(void *pvState)
+{
+    TelemetryLatestOpen(pvState, TELEMETRY_FMT_FORM);
+}
+
+static void
+TelemetryLatestBinOpen(void *pvState)
+{
+    TelemetryLatestOpen(pvState, TELEMETRY_FMT_BIN);
+}
+
+static void
+TelemetryHistoryBinOpen(void *pvState)
+{
+    TelemetryHistoryOpen(pvState, TELEMETRY_FMT_BIN);
+}
+
+static void
+TelemetryLatestJSONOpen(void *pvState)
+{
+    TelemetryLatestOpen(pvState, TELEMETRY_FMT_JSON);
+}
+
+static void
+TelemetryHistoryJSONOpen(void *pvState)
+{
+    TelemetryHistoryOpen(pvState, TELEMETRY_FMT_JSON);
+}
+
+//*****************************************************************************
+//
+// The telemetry files.
+//
+//*****************************************************************************
+static const tFSGenerator g_psTelemetryFiles[] =
+{
+    {
+        "/dataread", sizeof(tTelemetryStream), TelemetryDataReadOpen,
+        TelemetryStreamRead
+    },
+    {
+        "/dataread.bin", sizeof(tTelemetryStream), TelemetryLatestBinOpen,
+        TelemetryStreamRead
+    },
+    {
+        "/history.bin", sizeof(tTelemetryStream), TelemetryHistoryBinOpen,
+        TelemetryStreamRead
+    },
+    {
+        "/data.json", sizeof(tTelemetryStream), TelemetryLatestJSONOpen,
+        TelemetryStreamRead
+    },
+    {
+        "/history.json", sizeof(tTelemetryStream), TelemetryHistoryJSONOpen,
+        TelemetryStreamRead
+    }
+};
+
+#define NUM_TELEMETRY_FILES     (sizeof(g_psTelemetryFiles) /                \
+                                 sizeof(g_psTelemetryFiles[0]))
+
+//*****************************************************************************
+//
+// Registers the telemetry files with the web server file system.
+//
+//*****************************************************************************
+void
+TelemetryFilesRegister(void)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < NUM_TELEMETRY_FILES; ui32Idx++)
+    {
+        FSGenRegister(&g_psTelemetryFiles[ui32Idx]);
+    }
+}
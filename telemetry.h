@@ -0,0 +1,116 @@
+//*****************************************************************************
+//
+// telemetry.h - Prototypes for the sensor sample store and its binary format.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+//*****************************************************************************
+//
+// The number of samples kept in the history.
+//
+//*****************************************************************************
+#define TELEMETRY_HISTORY_LEN   64
+
+//*****************************************************************************
+//
+// The binary telemetry format served as /dataread.bin (the latest sample) and
+// /history.bin (the samples in the history, oldest first).  All fields are
+// little-endian.  A file is a header followed by a number of records:
+//
+// Header (8 bytes):
+//     uint8_t  magic[2]       'T', 'M'
+//     uint8_t  version        TELEMETRY_BIN_VERSION
+//     uint8_t  record_size    TELEMETRY_BIN_REC_SIZE
+//     uint16_t count          the number of records that follow
+//     uint16_t reserved       0
+//
+// Record (16 bytes):
+//     uint32_t seq            sample sequence number, starting at 1
+//     uint32_t timestamp      milliseconds since boot when sampled
+//     int32_t  time           the time counter
+//     int16_t  temperature    temperature in hundredths of a degree C
+//     uint16_t reserved       0
+//
+// Fields are only ever appended to a record, so a client reading older
+// versions can skip the tail of each record using record_size.
+//
+//*****************************************************************************
+#define TELEMETRY_BIN_VERSION   1
+#define TELEMETRY_BIN_HDR_SIZE  8
+#define TELEMETRY_BIN_REC_SIZE  16
+
+//*****************************************************************************
+//
+// A telemetry sample.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The sequence number of the sample, 0 if no sample has been taken.
+    //
+    uint32_t ui32Seq;
+
+    //
+    // The time the sample was taken, in milliseconds since boot.
+    //
+    uint32_t ui32TimeMS;
+
+    //
+    // The time counter: in the history, its value when the sample was taken;
+    // in the current snapshot, its latest value.
+    //
+    int32_t i32Time;
+
+    //
+    // The temperature in hundredths of a degree C.
+    //
+    int32_t i32TempCenti;
+}
+tTelemetrySample;
+
+//*****************************************************************************
+//
+// Converts a temperature in hundredths of a degree to tenths, rounding to the
+// nearest tenth (halves away from zero).
+//
+//*****************************************************************************
+#define TELEMETRY_CENTI_TO_TENTHS(i32Centi)                                   \
+    (((i32Centi) + (((i32Centi) < 0) ? -5 : 5)) / 10)
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void TelemetryInit(void);
+extern void TelemetryTimeSet(int32_t i32Time);
+extern void TelemetryTemperatureSet(float fTemperature);
+extern void TelemetrySampleGet(tTelemetrySample *psSample);
+extern bool TelemetryWaitUpdate(uint32_t ui32Ticks);
+extern bool TelemetryHistoryGet(uint32_t ui32Seq, tTelemetrySample *psSample);
+extern void TelemetryHistoryRange(uint32_t *pui32First, uint32_t *pui32Count);
+extern void TelemetryFilesRegister(void);
+
+#endif // __TELEMETRY_H__
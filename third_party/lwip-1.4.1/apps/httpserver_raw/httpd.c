@@ -82,6 +82,7 @@
 
 #include "httpserver_raw/httpd.h"
 #include "httpserver_raw/httpd_structs.h"
+#include "httpd_latency.h"
 #include "lwip/tcp.h"
 #include "httpserver_raw/fs.h"
 
@@ -198,6 +199,20 @@
 #define LWIP_HTTPD_ABORT_ON_CLOSE_MEM_ERROR  0
 #endif
 
+/** Set this to 1 to keep HTTP/1.1 connections open after a response.
+ * Files with an in-memory image are sent with a Content-Length header, files
+ * that are produced through fs_read() (file->data == NULL) are sent with
+ * chunked transfer-encoding so that their length need not be known up front.
+ * HTTP/1.0 clients, SSI files and error responses still close the connection
+ * to delimit the response.  Requires LWIP_HTTPD_DYNAMIC_HEADERS. */
+#ifndef LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE      0
+#endif
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE && !LWIP_HTTPD_DYNAMIC_HEADERS
+#error LWIP_HTTPD_SUPPORT_11_KEEPALIVE needs LWIP_HTTPD_DYNAMIC_HEADERS
+#endif
+
 #ifndef true
 #define true ((u8_t)1)
 #endif
@@ -217,8 +232,12 @@
 #define HTTP_IS_DATA_VOLATILE(hs) ((hs->file < (char *)0x20000000) ? 0 : TCP_WRITE_FLAG_COPY)*/
 #ifndef HTTP_IS_DATA_VOLATILE
 #if LWIP_HTTPD_SSI
-/* Copy for SSI files, no copy for non-SSI files */
-#define HTTP_IS_DATA_VOLATILE(hs)   ((hs)->tag_check ? TCP_WRITE_FLAG_COPY : 0)
+/* Copy for SSI files and for files read into hs->buf through fs_read(), no
+   copy for non-SSI files sent from the file system image */
+#define HTTP_IS_DATA_VOLATILE(hs)   (((hs)->tag_check || \
+                                      (((hs)->handle != NULL) && \
+                                       ((hs)->handle->data == NULL))) ? \
+                                     TCP_WRITE_FLAG_COPY : 0)
 #else /* LWIP_HTTPD_SSI */
 /** Default: don't copy if the data is sent from file-system directly */
 #define HTTP_IS_DATA_VOLATILE(hs) (((hs->file != NULL) && (hs->handle != NULL) && (hs->file == \
@@ -227,9 +246,18 @@
 #endif /* LWIP_HTTPD_SSI */
 #endif
 
-/** Default: headers are sent from ROM */
+/** Default: headers are sent from ROM, except for the Content-Length header
+ * which is generated into struct http_state for every response */
 #ifndef HTTP_IS_HDR_VOLATILE
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#define HTTP_IS_HDR_VOLATILE(hs, ptr) \
+  ((((const char *)(ptr) >= (hs)->hdr_content_len) && \
+    ((const char *)(ptr) < (hs)->hdr_content_len + \
+                           sizeof((hs)->hdr_content_len))) ? \
+   TCP_WRITE_FLAG_COPY : 0)
+#else /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #define HTTP_IS_HDR_VOLATILE(hs, ptr) 0
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #endif
 
 #if LWIP_HTTPD_SSI
@@ -267,12 +295,73 @@ static char http_post_response_filename[LWIP_HTTPD_POST_MAX_RESPONSE_URI_LEN+1];
 #endif /* LWIP_HTTPD_SUPPORT_POST */
 
 #if LWIP_HTTPD_DYNAMIC_HEADERS
-/* The number of individual strings that comprise the headers sent before each
- * requested file.
+/* The individual strings that comprise the headers sent before each
+ * requested file and their number.
  */
-#define NUM_FILE_HDR_STRINGS 3
+#define HDR_STRINGS_IDX_HTTP_STATUS   0 /* e.g. "HTTP/1.0 200 OK\r\n" */
+#define HDR_STRINGS_IDX_SERVER_NAME   1 /* e.g. "Server: lwIP\r\n" */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#define HDR_STRINGS_IDX_FRAMING       2 /* Content-Length, chunked or close */
+#define HDR_STRINGS_IDX_CONTENT_TYPE  3 /* Content-type, ends the headers */
+#define NUM_FILE_HDR_STRINGS          4
+#else /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#define HDR_STRINGS_IDX_CONTENT_TYPE  2 /* Content-type, ends the headers */
+#define NUM_FILE_HDR_STRINGS          3
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
 
+#if LWIP_HTTPD_DYNAMIC_HEADERS
+/** Content types for file extensions not listed in httpd_structs.h */
+typedef struct
+{
+  const char *extension;
+  const char *content_type;
+} tHTTPExtraHeader;
+
+static const tHTTPExtraHeader g_psHTTPExtraHeaders[] =
+{
+  { "bin", "Content-type: application/octet-stream\r\n\r\n" },
+  { "json", "Content-type: application/json\r\n\r\n" }
+};
+
+#define NUM_HTTP_EXTRA_HEADERS \
+  (sizeof(g_psHTTPExtraHeaders) / sizeof(tHTTPExtraHeader))
+#endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#define HTTP11_STATUS_OK          "HTTP/1.1 200 OK\r\n"
+#define HTTP11_CONNECTION_CLOSE   "Connection: close\r\n"
+/* Request header name, lower case since it is compared case-insensitively */
+#define HTTP11_HDR_CONNECTION     "connection:"
+#define HTTP11_HDR_CONNECTION_LEN 11
+#define HTTP11_CHUNKED            "Transfer-Encoding: chunked\r\n"
+#define HTTP11_CONTENT_LEN        "Content-Length: "
+#define HTTP11_CONTENT_LEN_LEN    16
+/* "Content-Length: " + 10 digits + CRLF + NUL */
+#define HTTP11_CONTENT_LEN_SIZE   (HTTP11_CONTENT_LEN_LEN + 10 + 2 + 1)
+
+/** Space reserved in front of each chunk read into hs->buf for the chunk-size
+ * line: up to 4 hex digits (hs->buf is never larger than 0xffff) and CRLF */
+#define HTTP_CHUNK_HDR_LEN        6
+/** Space reserved behind each chunk for the CRLF that ends it */
+#define HTTP_CHUNK_TRAILER_LEN    2
+/** The last-chunk marker that ends a chunked body (no trailer headers) */
+#define HTTP_CHUNK_LAST           "0\r\n\r\n"
+#define HTTP_CHUNK_LAST_LEN       5
+
+/** States of a response body sent with chunked transfer-encoding */
+enum chunk_state {
+  CHUNK_NONE,     /* The body is not chunked */
+  CHUNK_DATA,     /* Sending data chunks read from the file */
+  CHUNK_LAST      /* The last-chunk marker has been set up for sending */
+};
+
+static const char http11_status_ok[] = HTTP11_STATUS_OK;
+static const char http11_connection_close[] = HTTP11_CONNECTION_CLOSE;
+static const char http11_chunked[] = HTTP11_CHUNKED;
+static const char http_chunk_last[] = HTTP_CHUNK_LAST;
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 #if LWIP_HTTPD_SSI
 
 #define HTTPD_LAST_TAG_PART 0xFFFF
@@ -334,9 +423,26 @@ struct http_state {
                         current string */
   u16_t hdr_index;   /* The index of the hdr string currently being sent. */
 #endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  char hdr_content_len[HTTP11_CONTENT_LEN_SIZE]; /* Content-Length header */
+  u8_t keepalive;   /* true if the connection is kept open after this file */
+  u8_t chunk_state; /* enum chunk_state of the response body */
+  struct pbuf *pipelined; /* Request received while sending the response */
+  u16_t pipelined_unrecved; /* Bytes of it not yet passed to tcp_recved */
+  u16_t req_len;    /* Length of the request parsed last, 0 if unknown */
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #if LWIP_HTTPD_TIMING
   u32_t time_started;
 #endif /* LWIP_HTTPD_TIMING */
+#if LWIP_HTTPD_LATENCY
+  u32_t lat_accept;  /* HTTPD_LATENCY_NOW() when the connection was accepted */
+  u32_t lat_start;   /* ... when the first byte of the request was received */
+  u32_t lat_parse;   /* Ticks spent parsing the request */
+  u32_t lat_handler; /* Ticks spent in fs_open() and fs_read() */
+  u8_t lat_route;    /* Route of the request, HTTPD_LATENCY_ROUTES if none */
+  u8_t lat_state;    /* enum http_latency_state of the connection */
+  u8_t lat_first;    /* true for the first request on the connection */
+#endif /* LWIP_HTTPD_LATENCY */
 #if LWIP_HTTPD_SUPPORT_POST
   u32_t post_content_len_left;
 #if LWIP_HTTPD_POST_MANUAL_WND
@@ -350,6 +456,7 @@ struct http_state {
 static err_t http_find_file(struct http_state *hs, const char *uri, int is_09);
 static err_t http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri);
 static err_t http_poll(void *arg, struct tcp_pcb *pcb);
+static err_t http_recv_data(struct tcp_pcb *pcb, struct http_state *hs, struct pbuf *p);
 
 #if LWIP_HTTPD_SSI
 /* SSI insert handler function pointer. */
@@ -370,6 +477,135 @@ const tCGI *g_pCGIs;
 int g_iNumCGIs;
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_LATENCY
+/** Where a connection is in timing a request */
+enum http_latency_state {
+  HTTP_LAT_NEW,     /* Accepted, no request received yet */
+  HTTP_LAT_IDLE,    /* Kept open, waiting for the next request */
+  HTTP_LAT_REQUEST, /* Receiving the request or sending the response */
+  HTTP_LAT_ACK      /* Response sent, waiting for it to be acknowledged */
+};
+
+/** The latency histograms, updated from the tcpip thread only */
+static struct httpd_latency_route httpd_latency_routes[HTTPD_LATENCY_ROUTES];
+
+/** Add an interval to a histogram */
+static void
+http_latency_record(u8_t route, u8_t phase, u32_t ticks)
+{
+  struct httpd_latency_route *r = &httpd_latency_routes[route];
+  u32_t scaled = ticks >> HTTPD_LATENCY_MIN_SHIFT;
+  u8_t bucket = 0;
+
+  while ((scaled != 0) && (bucket < (HTTPD_LATENCY_BUCKETS - 1))) {
+    bucket++;
+    scaled >>= 1;
+  }
+  r->hist[phase][bucket]++;
+  if (ticks > r->max[phase]) {
+    r->max[phase] = ticks;
+  }
+}
+
+/** Find the route of a URI, claiming a free one for a URI not seen before.
+ * URIs that agree in their first HTTPD_LATENCY_URI_LEN characters share a
+ * route, and URIs seen once all routes are taken share the last.
+ */
+static u8_t
+http_latency_route_find(const char *uri)
+{
+  u8_t route;
+
+  if (uri == NULL) {
+    return HTTPD_LATENCY_ROUTES - 1;
+  }
+  for (route = 0; route < (HTTPD_LATENCY_ROUTES - 1); route++) {
+    char *name = httpd_latency_routes[route].uri;
+    if (name[0] == 0) {
+      strncpy(name, uri, HTTPD_LATENCY_URI_LEN);
+      name[HTTPD_LATENCY_URI_LEN] = 0;
+      return route;
+    }
+    if (strncmp(name, uri, HTTPD_LATENCY_URI_LEN) == 0) {
+      return route;
+    }
+  }
+  return HTTPD_LATENCY_ROUTES - 1;
+}
+
+/** Start timing a request when its first byte is received */
+static void
+http_latency_request(struct http_state *hs)
+{
+  if (hs->lat_state == HTTP_LAT_REQUEST) {
+    /* the rest of a request received in several segments */
+    return;
+  }
+  hs->lat_start = HTTPD_LATENCY_NOW();
+  hs->lat_first = (hs->lat_state == HTTP_LAT_NEW);
+  hs->lat_parse = 0;
+  hs->lat_handler = 0;
+  hs->lat_route = HTTPD_LATENCY_ROUTES;
+  hs->lat_state = HTTP_LAT_REQUEST;
+}
+
+/** The response has been produced: record all but the time to the last ACK */
+static void
+http_latency_response_end(struct http_state *hs)
+{
+  if ((hs->lat_state != HTTP_LAT_REQUEST) ||
+      (hs->lat_route == HTTPD_LATENCY_ROUTES)) {
+    return;
+  }
+  if (hs->lat_first) {
+    http_latency_record(hs->lat_route, HTTPD_LATENCY_ACCEPT,
+                        hs->lat_start - hs->lat_accept);
+  }
+  http_latency_record(hs->lat_route, HTTPD_LATENCY_PARSE, hs->lat_parse);
+  http_latency_record(hs->lat_route, HTTPD_LATENCY_HANDLER, hs->lat_handler);
+  hs->lat_state = HTTP_LAT_ACK;
+}
+
+/** Record the time to the last ACK once everything sent has been acked */
+static void
+http_latency_acked(struct http_state *hs, struct tcp_pcb *pcb)
+{
+  if ((hs->lat_state == HTTP_LAT_ACK) &&
+      (pcb->unsent == NULL) && (pcb->unacked == NULL)) {
+    http_latency_record(hs->lat_route, HTTPD_LATENCY_ACK,
+                        HTTPD_LATENCY_NOW() - hs->lat_start);
+    hs->lat_state = HTTP_LAT_IDLE;
+  }
+}
+
+/**
+ * Get the latency histograms of a route.
+ *
+ * @param route index of the route, 0 to HTTPD_LATENCY_ROUTES - 1
+ * @return the histograms, or NULL if the route has not been used.  They are
+ *         updated by the tcpip thread, so should be read from it.
+ */
+const struct httpd_latency_route *
+httpd_latency_get(u8_t route)
+{
+  if ((route >= HTTPD_LATENCY_ROUTES) ||
+      (httpd_latency_routes[route].uri[0] == 0)) {
+    return NULL;
+  }
+  return &httpd_latency_routes[route];
+}
+
+/**
+ * Clear the latency histograms and free all routes.
+ */
+void
+httpd_latency_reset(void)
+{
+  memset(httpd_latency_routes, 0, sizeof(httpd_latency_routes));
+  httpd_latency_routes[HTTPD_LATENCY_ROUTES - 1].uri[0] = '*';
+}
+#endif /* LWIP_HTTPD_LATENCY */
+
 #if LWIP_HTTPD_STRNSTR_PRIVATE
 /** Like strstr but does not need 'buffer' to be NULL-terminated */
 static char*
@@ -389,6 +625,78 @@ strnstr(const char* buffer, const char* token, size_t n)
 }
 #endif /* LWIP_HTTPD_STRNSTR_PRIVATE */
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** Like strncmp but case-insensitive; 'lower' must be in lower case */
+static int
+http_strnicmp_lower(const char* str, const char* lower, size_t n)
+{
+  for (; n > 0; n--, str++, lower++) {
+    char c = *str;
+    if ((c >= 'A') && (c <= 'Z')) {
+      c += 'a' - 'A';
+    }
+    if (c != *lower) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/** Check whether the client asks for the connection to be closed after the
+ * response, i.e. sends a Connection header listing the "close" option.
+ * Header names and connection options are case-insensitive (RFC 7230).
+ *
+ * @param hdrs the request headers, following the request line
+ * @param len number of bytes at hdrs (need not be null-terminated); the last
+ *        header need not be terminated by CRLF
+ * @return 1 if the connection is to be closed, 0 otherwise
+ */
+static u8_t
+http_wants_close(const char* hdrs, u16_t len)
+{
+  const char* end = hdrs + len;
+  const char* line = hdrs;
+
+  while (line < end) {
+    const char* eol = line;
+    while ((eol < end) && (*eol != '\r') && (*eol != '\n')) {
+      eol++;
+    }
+    if (eol == line) {
+      /* empty line: end of the headers */
+      break;
+    }
+    if ((eol - line >= HTTP11_HDR_CONNECTION_LEN) &&
+        !http_strnicmp_lower(line, HTTP11_HDR_CONNECTION, HTTP11_HDR_CONNECTION_LEN)) {
+      /* the value is a comma-separated list of options */
+      const char* opt = line + HTTP11_HDR_CONNECTION_LEN;
+      while (opt < eol) {
+        const char* opt_end;
+        while ((opt < eol) && ((*opt == ' ') || (*opt == '\t') || (*opt == ','))) {
+          opt++;
+        }
+        opt_end = opt;
+        while ((opt_end < eol) && (*opt_end != ' ') && (*opt_end != '\t') && (*opt_end != ',')) {
+          opt_end++;
+        }
+        if ((opt_end - opt == 5) && !http_strnicmp_lower(opt, "close", 5)) {
+          return 1;
+        }
+        opt = opt_end;
+      }
+    }
+    line = eol;
+    if ((line < end) && (*line == '\r')) {
+      line++;
+    }
+    if ((line < end) && (*line == '\n')) {
+      line++;
+    }
+  }
+  return 0;
+}
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 /** Allocate a struct http_state. */
 static struct http_state*
 http_state_alloc(void)
@@ -410,6 +718,33 @@ http_state_alloc(void)
   return ret;
 }
 
+/** Release the file and the read buffer of a struct http_state once the
+ * response has been sent (or the connection is closed).
+ */
+static void
+http_state_eof(struct http_state *hs)
+{
+  if(hs->handle) {
+#if LWIP_HTTPD_LATENCY
+    http_latency_response_end(hs);
+#endif /* LWIP_HTTPD_LATENCY */
+#if LWIP_HTTPD_TIMING
+    u32_t ms_needed = sys_now() - hs->time_started;
+    u32_t needed = LWIP_MAX(1, (ms_needed/100));
+    LWIP_DEBUGF(HTTPD_DEBUG_TIMING, ("httpd: needed %"U32_F" ms to send file of %d bytes -> %"U32_F" bytes/sec\n",
+      ms_needed, hs->handle->len, ((((u32_t)hs->handle->len) * 10) / needed)));
+#endif /* LWIP_HTTPD_TIMING */
+    fs_close(hs->handle);
+    hs->handle = NULL;
+  }
+#if LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS
+  if (hs->buf != NULL) {
+    mem_free(hs->buf);
+    hs->buf = NULL;
+  }
+#endif /* LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS */
+}
+
 /** Free a struct http_state.
  * Also frees the file data if dynamic.
  */
@@ -417,22 +752,19 @@ static void
 http_state_free(struct http_state *hs)
 {
   if (hs != NULL) {
-    if(hs->handle) {
-#if LWIP_HTTPD_TIMING
-      u32_t ms_needed = sys_now() - hs->time_started;
-      u32_t needed = LWIP_MAX(1, (ms_needed/100));
-      LWIP_DEBUGF(HTTPD_DEBUG_TIMING, ("httpd: needed %"U32_F" ms to send file of %d bytes -> %"U32_F" bytes/sec\n",
-        ms_needed, hs->handle->len, ((((u32_t)hs->handle->len) * 10) / needed)));
-#endif /* LWIP_HTTPD_TIMING */
-      fs_close(hs->handle);
-      hs->handle = NULL;
+    http_state_eof(hs);
+#if LWIP_HTTPD_LATENCY
+    if (hs->lat_state == HTTP_LAT_ACK) {
+      /* the last ACK of the response will not be seen */
+      httpd_latency_routes[hs->lat_route].ack_missed++;
     }
-#if LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS
-    if (hs->buf != NULL) {
-      mem_free(hs->buf);
-      hs->buf = NULL;
+#endif /* LWIP_HTTPD_LATENCY */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    if (hs->pipelined != NULL) {
+      pbuf_free(hs->pipelined);
+      hs->pipelined = NULL;
     }
-#endif /* LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS */
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #if HTTPD_USE_MEM_POOL
     memp_free(MEMP_HTTPD_STATE, hs);
 #else /* HTTPD_USE_MEM_POOL */
@@ -441,42 +773,76 @@ http_state_free(struct http_state *hs)
   }
 }
 
-/** Call tcp_write() in a loop trying smaller and smaller length
+/** Number of send queue entries (pbufs) a single segment takes up when it is
+ * enqueued by tcp_write() with the given apiflags: copied data lives in one
+ * PBUF_RAM per segment, referenced data needs a header pbuf plus a PBUF_ROM.
+ */
+#define HTTP_WRITE_QUEUE_COST(apiflags) \
+  (((apiflags) & TCP_WRITE_FLAG_COPY) ? 1 : 2)
+
+/** Size a tcp_write() from the free send buffer and send queue headroom
+ *
+ * If the data does not fit completely, only whole MSS-sized segments are
+ * enqueued.  If not even one segment fits, nothing is written and ERR_MEM is
+ * returned: the caller keeps its data and is called again from http_sent()
+ * (or http_poll()) once the remote host has acknowledged queued data.  This
+ * avoids flooding the send queue with tiny segments when memory is tight.
  *
  * @param pcb tcp_pcb to send
  * @param ptr Data to send
  * @param length Length of data to send (in/out: on return, contains the
- *        amount of data sent)
+ *        amount of data sent, 0 if the write was deferred)
  * @param apiflags directly passed to tcp_write
- * @return the return value of tcp_write
+ * @return the return value of tcp_write or ERR_MEM if the write was deferred
  */
 static err_t
 http_write(struct tcp_pcb *pcb, const void* ptr, u16_t *length, u8_t apiflags)
 {
-   u16_t len;
+   u16_t len, mss;
+   u32_t max_len, queue_free;
    err_t err;
    LWIP_ASSERT("length != NULL", length != NULL);
    len = *length;
-   do {
-     LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Trying to send %d bytes\n", len));
-     err = tcp_write(pcb, ptr, len, apiflags);
-     if (err == ERR_MEM) {
-       if ((tcp_sndbuf(pcb) == 0) ||
-           (tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN)) {
-         /* no need to try smaller sizes */
-         len = 1;
-       } else {
-         len /= 2;
-       }
-       LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE,
-                   ("Send failed, trying less (%d bytes)\n", len));
+   if (len == 0) {
+     return ERR_OK;
+   }
+   mss = tcp_mss(pcb);
+
+   /* How much could be enqueued without running into ERR_MEM? */
+   max_len = tcp_sndbuf(pcb);
+   if (tcp_sndqueuelen(pcb) < TCP_SND_QUEUELEN) {
+     queue_free = (TCP_SND_QUEUELEN - tcp_sndqueuelen(pcb)) /
+                  HTTP_WRITE_QUEUE_COST(apiflags);
+   } else {
+     queue_free = 0;
+   }
+   max_len = LWIP_MIN(max_len, queue_free * mss);
+
+   if (len > max_len) {
+     /* Not everything fits: only send full segments. */
+     len = (u16_t)(max_len - (max_len % mss));
+     if (len == 0) {
+       LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Send deferred (sndbuf %d, queuelen %d)\n",
+                   tcp_sndbuf(pcb), tcp_sndqueuelen(pcb)));
+       *length = 0;
+       return ERR_MEM;
      }
-   } while ((err == ERR_MEM) && (len > 1));
+   }
+
+   LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Trying to send %d bytes\n", len));
+   err = tcp_write(pcb, ptr, len, apiflags);
+   if ((err == ERR_MEM) && (len > mss)) {
+     /* The global segment or pbuf pools ran dry even though this pcb had
+      * room: try a single segment, else wait for the next ACK. */
+     len = mss;
+     err = tcp_write(pcb, ptr, len, apiflags);
+   }
 
    if (err == ERR_OK) {
      LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Sent %d bytes\n", len));
    } else {
      LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Send failed with err %d (\"%s\")\n", err, lwip_strerr(err)));
+     len = 0;
    }
 
    *length = len;
@@ -511,6 +877,15 @@ http_close_conn(struct tcp_pcb *pcb, struct http_state *hs)
 #endif /* LWIP_HTTPD_SUPPORT_POST*/
 
 
+#if LWIP_HTTPD_LATENCY
+  if (hs != NULL) {
+    /* Record the time to the last ACK if it has already arrived; otherwise
+       http_state_free counts the response in ack_missed */
+    http_state_eof(hs);
+    http_latency_acked(hs, pcb);
+  }
+#endif /* LWIP_HTTPD_LATENCY */
+
   tcp_arg(pcb, NULL);
   tcp_recv(pcb, NULL);
   tcp_err(pcb, NULL);
@@ -528,6 +903,220 @@ http_close_conn(struct tcp_pcb *pcb, struct http_state *hs)
   }
   return err;
 }
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** Set while a pipelined request is handled, so that the response to it
+ * ending right away does not start on the next one from within; that one is
+ * picked up when the response is acknowledged instead */
+static u8_t http_pipelined_active;
+
+/**
+ * Handle the data held back in hs->pipelined (see http_recv) if the response
+ * before it is complete.
+ *
+ * @param pcb the tcp pcb of the connection
+ * @param hs connection state
+ * @return true if the data was handled; hs may have been freed then
+ */
+static u8_t
+http_recv_pipelined(struct tcp_pcb *pcb, struct http_state *hs)
+{
+  struct pbuf *p = hs->pipelined;
+
+  if ((p == NULL) || (hs->handle != NULL) || (hs->file != NULL) ||
+      http_pipelined_active) {
+    return false;
+  }
+  LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv_pipelined: %"U16_F" bytes\n", p->tot_len));
+  hs->pipelined = NULL;
+  if (hs->pipelined_unrecved != 0) {
+    tcp_recved(pcb, hs->pipelined_unrecved);
+    hs->pipelined_unrecved = 0;
+  }
+  http_pipelined_active = true;
+  http_recv_data(pcb, hs, p);
+  http_pipelined_active = false;
+  return true;
+}
+
+/**
+ * Free the request just parsed, keeping whatever follows its headers as the
+ * next, pipelined request (see http_recv_pipelined).
+ *
+ * @param hs connection state; hs->req_len is the length of the request
+ * @param p the pbuf chain starting with the request
+ */
+static void
+http_keep_pipelined(struct http_state *hs, struct pbuf *p)
+{
+  u16_t skip = hs->req_len;
+
+  if (!hs->keepalive || (skip == 0) || (skip >= p->tot_len) ||
+      (hs->pipelined != NULL)) {
+    pbuf_free(p);
+    return;
+  }
+  while (skip >= p->len) {
+    struct pbuf *q = p->next;
+    skip -= p->len;
+    p->next = NULL;
+    p->tot_len = p->len;
+    pbuf_free(p);
+    p = q;
+  }
+  pbuf_header(p, -(s16_t)skip);
+  hs->pipelined = p;
+}
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
+/**
+ * The response has been sent completely: close the connection or, for a
+ * persistent HTTP/1.1 connection, get ready to receive the next request.
+ *
+ * @param pcb the tcp pcb of the connection
+ * @param hs connection state
+ * @return true if the connection is still open (data may be pending), false
+ *         if it was closed or a pipelined request was handled: hs may have
+ *         been freed then
+ */
+static u8_t
+http_end_response(struct tcp_pcb *pcb, struct http_state *hs)
+{
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  if (hs->keepalive) {
+    LWIP_DEBUGF(HTTPD_DEBUG, ("End of file, keeping connection %p open\n",
+                (void*)pcb));
+    http_state_eof(hs);
+    hs->file = NULL;
+    hs->left = 0;
+    hs->retries = 0;
+    hs->hdr_index = NUM_FILE_HDR_STRINGS;
+    hs->chunk_state = CHUNK_NONE;
+    /* hs->keepalive stays set while the connection waits for a request */
+#if LWIP_HTTPD_LATENCY
+    http_latency_acked(hs, pcb);
+#endif /* LWIP_HTTPD_LATENCY */
+    /* Go on with a request received meanwhile: no further http_sent may
+       come if everything sent has already been acknowledged */
+    if (http_recv_pipelined(pcb, hs)) {
+      return false;
+    }
+    return true;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+  http_close_conn(pcb, hs);
+  return false;
+}
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/**
+ * Frame a block read into hs->buf as one chunk: the chunk-size line goes into
+ * the space reserved in front of the data and CRLF behind it.
+ *
+ * @param hs connection state; hs->buf holds count bytes of data at offset
+ *        HTTP_CHUNK_HDR_LEN
+ * @param count number of data bytes in the chunk (> 0)
+ */
+static void
+http_frame_chunk(struct http_state *hs, int count)
+{
+  static const char hex[] = "0123456789abcdef";
+  char *data = hs->buf + HTTP_CHUNK_HDR_LEN;
+  char *start = data;
+  int size = count;
+
+  LWIP_ASSERT("chunk size fits the header", (count > 0) && (count <= 0xffff));
+  data[count] = '\r';
+  data[count + 1] = '\n';
+  *--start = '\n';
+  *--start = '\r';
+  do {
+    *--start = hex[size & 0xf];
+    size >>= 4;
+  } while (size != 0);
+
+  hs->file = start;
+  hs->left = (u32_t)(data - start) + count + HTTP_CHUNK_TRAILER_LEN;
+}
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
+/**
+ * The end of the file has been reached: for a chunked body, set up the
+ * last-chunk marker as the remaining data to send.
+ *
+ * @param hs connection state
+ * @return true if there is a marker to send, false if the response is done
+ */
+static u8_t
+http_chunk_end(struct http_state *hs)
+{
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  if (hs->chunk_state == CHUNK_DATA) {
+    hs->chunk_state = CHUNK_LAST;
+    hs->file = (char*)http_chunk_last;
+    hs->left = HTTP_CHUNK_LAST_LEN;
+    return true;
+  }
+#else /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+  LWIP_UNUSED_ARG(hs);
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+  return false;
+}
+
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+
+/**
+ * Decide how the end of the response is signalled to the client and set up
+ * the matching header: a Content-Length for in-memory files, chunked
+ * transfer-encoding for files read through fs_read(), or closing the
+ * connection.  Called by http_init_file once the headers are known.
+ *
+ * @param hs http connection state
+ * @param is_09 1 if the request is HTTP/0.9
+ */
+static void
+http_set_framing(struct http_state *hs, int is_09)
+{
+  u8_t keepalive = hs->keepalive;
+  hs->keepalive = false;
+  hs->chunk_state = CHUNK_NONE;
+
+  if (hs->hdr_index >= NUM_FILE_HDR_STRINGS) {
+    /* No headers are sent, so only closing can delimit the response. */
+    return;
+  }
+  if (keepalive && !is_09 && (hs->handle != NULL) &&
+      (hs->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] == g_psHTTPHeaderStrings[HTTP_HDR_OK])
+#if LWIP_HTTPD_SSI
+      /* SSI inserts change the length of the file */
+      && !hs->tag_check
+#endif /* LWIP_HTTPD_SSI */
+     ) {
+    hs->keepalive = true;
+    hs->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = http11_status_ok;
+    if (hs->handle->data == NULL) {
+      hs->chunk_state = CHUNK_DATA;
+      hs->hdrs[HDR_STRINGS_IDX_FRAMING] = http11_chunked;
+    } else {
+      u32_t len = hs->left;
+      char *p = &hs->hdr_content_len[HTTP11_CONTENT_LEN_SIZE - 1];
+      *p = 0;
+      *--p = '\n';
+      *--p = '\r';
+      do {
+        *--p = (char)('0' + (len % 10));
+        len /= 10;
+      } while (len != 0);
+      p -= HTTP11_CONTENT_LEN_LEN;
+      MEMCPY(p, HTTP11_CONTENT_LEN, HTTP11_CONTENT_LEN_LEN);
+      hs->hdrs[HDR_STRINGS_IDX_FRAMING] = p;
+    }
+  } else {
+    hs->hdrs[HDR_STRINGS_IDX_FRAMING] = http11_connection_close;
+  }
+}
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 #if LWIP_HTTPD_CGI
 /**
  * Extract URI parameters from the parameter-part of an URI in the form
@@ -665,22 +1254,24 @@ static void
 get_http_headers(struct http_state *pState, char *pszURI)
 {
   unsigned int iLoop;
+  unsigned int iExtra;
   char *pszWork;
   char *pszExt;
   char *pszVars;
 
-  /* Ensure that we initialize the loop counter. */
+  /* Ensure that we initialize the loop counters. */
   iLoop = 0;
+  iExtra = NUM_HTTP_EXTRA_HEADERS;
 
   /* In all cases, the second header we send is the server identification
      so set it here. */
-  pState->hdrs[1] = g_psHTTPHeaderStrings[HTTP_HDR_SERVER];
+  pState->hdrs[HDR_STRINGS_IDX_SERVER_NAME] = g_psHTTPHeaderStrings[HTTP_HDR_SERVER];
 
   /* Is this a normal file or the special case we use to send back the
      default "404: Page not found" response? */
   if (pszURI == NULL) {
-    pState->hdrs[0] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_FOUND];
-    pState->hdrs[2] = g_psHTTPHeaderStrings[DEFAULT_404_HTML];
+    pState->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_FOUND];
+    pState->hdrs[HDR_STRINGS_IDX_CONTENT_TYPE] = g_psHTTPHeaderStrings[DEFAULT_404_HTML];
 
     /* Set up to send the first header string. */
     pState->hdr_index = 0;
@@ -692,13 +1283,13 @@ get_http_headers(struct http_state *pState, char *pszURI)
        indicative of a 404 server error whereas all other files require
        the 200 OK header. */
     if (strstr(pszURI, "404")) {
-      pState->hdrs[0] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_FOUND];
+      pState->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_FOUND];
     } else if (strstr(pszURI, "400")) {
-      pState->hdrs[0] = g_psHTTPHeaderStrings[HTTP_HDR_BAD_REQUEST];
+      pState->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = g_psHTTPHeaderStrings[HTTP_HDR_BAD_REQUEST];
     } else if (strstr(pszURI, "501")) {
-      pState->hdrs[0] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_IMPL];
+      pState->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = g_psHTTPHeaderStrings[HTTP_HDR_NOT_IMPL];
     } else {
-      pState->hdrs[0] = g_psHTTPHeaderStrings[HTTP_HDR_OK];
+      pState->hdrs[HDR_STRINGS_IDX_HTTP_STATUS] = g_psHTTPHeaderStrings[HTTP_HDR_OK];
     }
 
     /* Determine if the URI has any variables and, if so, temporarily remove
@@ -721,12 +1312,23 @@ get_http_headers(struct http_state *pState, char *pszURI)
     for(iLoop = 0; (iLoop < NUM_HTTP_HEADERS) && pszExt; iLoop++) {
       /* Have we found a matching extension? */
       if(!strcmp(g_psHTTPHeaders[iLoop].extension, pszExt)) {
-        pState->hdrs[2] =
+        pState->hdrs[HDR_STRINGS_IDX_CONTENT_TYPE] =
           g_psHTTPHeaderStrings[g_psHTTPHeaders[iLoop].headerIndex];
         break;
       }
     }
 
+    /* If not, is it one of the extra types we know about? */
+    if(iLoop == NUM_HTTP_HEADERS) {
+      for(iExtra = 0; (iExtra < NUM_HTTP_EXTRA_HEADERS) && pszExt; iExtra++) {
+        if(!strcmp(g_psHTTPExtraHeaders[iExtra].extension, pszExt)) {
+          pState->hdrs[HDR_STRINGS_IDX_CONTENT_TYPE] =
+            g_psHTTPExtraHeaders[iExtra].content_type;
+          break;
+        }
+      }
+    }
+
     /* Reinstate the parameter marker if there was one in the original URI. */
     if(pszVars) {
       *pszVars = '?';
@@ -742,9 +1344,9 @@ get_http_headers(struct http_state *pState, char *pszURI)
     pState->hdr_index = NUM_FILE_HDR_STRINGS;
   } else {
     /* Did we find a matching extension? */
-    if(iLoop == NUM_HTTP_HEADERS) {
+    if((iLoop == NUM_HTTP_HEADERS) && (iExtra == NUM_HTTP_EXTRA_HEADERS)) {
       /* No - use the default, plain text file type. */
-      pState->hdrs[2] = g_psHTTPHeaderStrings[HTTP_HDR_DEFAULT_TYPE];
+      pState->hdrs[HDR_STRINGS_IDX_CONTENT_TYPE] = g_psHTTPHeaderStrings[HTTP_HDR_DEFAULT_TYPE];
     }
 
     /* Set up to send the first header string. */
@@ -765,7 +1367,6 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
 {
   err_t err;
   u16_t len;
-  u16_t mss;
   u8_t data_to_send = false;
 #if LWIP_HTTPD_DYNAMIC_HEADERS
   u16_t hdrlen, sendlen;
@@ -833,7 +1434,7 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
     * the header information we just wrote immediately.  If there are no
     * more headers to send, but we do have file data to send, drop through
     * to try to send some file data too. */
-    if((hs->hdr_index < NUM_FILE_HDR_STRINGS) || !hs->file) {
+    if((hs->hdr_index < NUM_FILE_HDR_STRINGS) || (hs->handle == NULL)) {
       LWIP_DEBUGF(HTTPD_DEBUG, ("tcp_output\n"));
       return 1;
     }
@@ -857,59 +1458,91 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
       return 0;
     }
     if (fs_bytes_left(hs->handle) <= 0) {
-      /* We reached the end of the file so this request is done.
-       * @todo: don't close here for HTTP/1.1? */
-      LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-      http_close_conn(pcb, hs);
-      return 0;
-    }
-#if LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS
-    /* Do we already have a send buffer allocated? */
-    if(hs->buf) {
-      /* Yes - get the length of the buffer */
-      count = hs->buf_len;
+      /* We reached the end of the file so this request is done once the
+       * last-chunk marker (if any) has been sent. */
+      if (!http_chunk_end(hs)) {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
+        http_end_response(pcb, hs);
+        return 0;
+      }
     } else {
-      /* We don't have a send buffer so allocate one up to 2mss bytes long. */
-      count = 2 * tcp_mss(pcb);
-      do {
-        hs->buf = (char*)mem_malloc((mem_size_t)count);
-        if (hs->buf != NULL) {
-          hs->buf_len = count;
-          break;
-        }
-        count = count / 2;
-      } while (count > 100);
+#if LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS
+      char *rdbuf;
+      /* Do we already have a send buffer allocated? */
+      if(hs->buf) {
+        /* Yes - get the length of the buffer */
+        count = hs->buf_len;
+      } else {
+        /* We don't have a send buffer so allocate one up to 2mss bytes long. */
+        count = 2 * tcp_mss(pcb);
+        do {
+          hs->buf = (char*)mem_malloc((mem_size_t)count);
+          if (hs->buf != NULL) {
+            hs->buf_len = count;
+            break;
+          }
+          count = count / 2;
+        } while (count > 100);
 
-      /* Did we get a send buffer? If not, return immediately. */
-      if (hs->buf == NULL) {
-        LWIP_DEBUGF(HTTPD_DEBUG, ("No buff\n"));
-        return 0;
+        /* Did we get a send buffer? If not, return immediately. */
+        if (hs->buf == NULL) {
+          LWIP_DEBUGF(HTTPD_DEBUG, ("No buff\n"));
+          return 0;
+        }
       }
-    }
+      rdbuf = hs->buf;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+      if (hs->chunk_state == CHUNK_DATA) {
+        /* Leave room for the chunk-size line and the trailing CRLF */
+        rdbuf += HTTP_CHUNK_HDR_LEN;
+        count -= HTTP_CHUNK_HDR_LEN + HTTP_CHUNK_TRAILER_LEN;
+      }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 
-    /* Read a block of data from the file. */
-    LWIP_DEBUGF(HTTPD_DEBUG, ("Trying to read %d bytes.\n", count));
+      /* Read a block of data from the file. */
+      LWIP_DEBUGF(HTTPD_DEBUG, ("Trying to read %d bytes.\n", count));
 
-    count = fs_read(hs->handle, hs->buf, count);
-    if(count < 0) {
-      /* We reached the end of the file so this request is done.
-       * @todo: don't close here for HTTP/1.1? */
-      LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-      http_close_conn(pcb, hs);
-      return 1;
-    }
-
-    /* Set up to send the block of data we just read */
-    LWIP_DEBUGF(HTTPD_DEBUG, ("Read %d bytes.\n", count));
-    hs->left = count;
-    hs->file = hs->buf;
+#if LWIP_HTTPD_LATENCY
+      {
+        u32_t started = HTTPD_LATENCY_NOW();
+        count = fs_read(hs->handle, rdbuf, count);
+        hs->lat_handler += HTTPD_LATENCY_NOW() - started;
+      }
+#else /* LWIP_HTTPD_LATENCY */
+      count = fs_read(hs->handle, rdbuf, count);
+#endif /* LWIP_HTTPD_LATENCY */
+      if(count < 0) {
+        /* We reached the end of the file so this request is done once the
+         * last-chunk marker (if any) has been sent. */
+        if (!http_chunk_end(hs)) {
+          LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
+          return http_end_response(pcb, hs);
+        }
+      } else if (count == 0) {
+        /* A generated file has no data available yet (and a zero-size
+         * chunk would end a chunked body), so try again on the next poll
+         * or when sent data is acknowledged. */
+        LWIP_DEBUGF(HTTPD_DEBUG, ("No data available yet.\n"));
+        return data_to_send;
+      } else {
+        /* Set up to send the block of data we just read */
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Read %d bytes.\n", count));
+        hs->left = count;
+        hs->file = hs->buf;
 #if LWIP_HTTPD_SSI
-    hs->parse_left = count;
-    hs->parsed = hs->buf;
+        hs->parse_left = count;
+        hs->parsed = hs->buf;
 #endif /* LWIP_HTTPD_SSI */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        if (hs->chunk_state == CHUNK_DATA) {
+          http_frame_chunk(hs, count);
+        }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+      }
 #else /* LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS */
-    LWIP_ASSERT("SSI and DYNAMIC_HEADERS turned off but eof not reached", 0);
+      LWIP_ASSERT("SSI and DYNAMIC_HEADERS turned off but eof not reached", 0);
 #endif /* LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS */
+    }
   }
 
 #if LWIP_HTTPD_SSI
@@ -918,18 +1551,9 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
     /* We are not processing an SHTML file so no tag checking is necessary.
      * Just send the data as we received it from the file. */
 
-    /* We cannot send more data than space available in the send
-       buffer. */
-    if (tcp_sndbuf(pcb) < hs->left) {
-      len = tcp_sndbuf(pcb);
-    } else {
-      len = (u16_t)hs->left;
-      LWIP_ASSERT("hs->left did not fit into u16_t!", (len == hs->left));
-    }
-    mss = tcp_mss(pcb);
-    if(len > (2 * mss)) {
-      len = 2 * mss;
-    }
+    /* Offer everything that is left: http_write() trims this to the
+       space available in the send buffer and queue. */
+    len = (u16_t)LWIP_MIN(hs->left, 0xffff);
 
     err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
     if (err == ERR_OK) {
@@ -949,19 +1573,11 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
 
     /* Do we have remaining data to send before parsing more? */
     if(hs->parsed > hs->file) {
-      /* We cannot send more data than space available in the send
-         buffer. */
-      if (tcp_sndbuf(pcb) < (hs->parsed - hs->file)) {
-        len = tcp_sndbuf(pcb);
-      } else {
-        LWIP_ASSERT("Data size does not fit into u16_t!",
-                    (hs->parsed - hs->file) <= 0xffff);
-        len = (u16_t)(hs->parsed - hs->file);
-      }
-      mss = tcp_mss(pcb);
-      if(len > (2 * mss)) {
-        len = 2 * mss;
-      }
+      /* http_write() trims this to the space available in the send
+         buffer and queue. */
+      LWIP_ASSERT("Data size does not fit into u16_t!",
+                  (hs->parsed - hs->file) <= 0xffff);
+      len = (u16_t)(hs->parsed - hs->file);
 
       err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
       if (err == ERR_OK) {
@@ -1251,18 +1867,11 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
      * file data to send so send it now. In TAG_SENDING state, we've already
      * handled this so skip the send if that's the case. */
     if((hs->tag_state != TAG_SENDING) && (hs->parsed > hs->file)) {
-      /* We cannot send more data than space available in the send
-         buffer. */
-      if (tcp_sndbuf(pcb) < (hs->parsed - hs->file)) {
-        len = tcp_sndbuf(pcb);
-      } else {
-        LWIP_ASSERT("Data size does not fit into u16_t!",
-                    (hs->parsed - hs->file) <= 0xffff);
-        len = (u16_t)(hs->parsed - hs->file);
-      }
-      if(len > (2 * tcp_mss(pcb))) {
-        len = 2 * tcp_mss(pcb);
-      }
+      /* http_write() trims this to the space available in the send
+         buffer and queue. */
+      LWIP_ASSERT("Data size does not fit into u16_t!",
+                  (hs->parsed - hs->file) <= 0xffff);
+      len = (u16_t)(hs->parsed - hs->file);
 
       err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
       if (err == ERR_OK) {
@@ -1275,12 +1884,25 @@ http_send_data(struct tcp_pcb *pcb, struct http_state *hs)
 #endif /* LWIP_HTTPD_SSI */
 
   if((hs->left == 0) && (fs_bytes_left(hs->handle) <= 0)) {
-    /* We reached the end of the file so this request is done.
-     * This adds the FIN flag right into the last data segment.
-     * @todo: don't close here for HTTP/1.1? */
-    LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-    http_close_conn(pcb, hs);
-    return 0;
+    if (http_chunk_end(hs)) {
+      /* Queue the last-chunk marker right behind the final chunk. */
+      len = (u16_t)hs->left;
+      err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
+      if (err == ERR_OK) {
+        data_to_send = true;
+        hs->file += len;
+        hs->left -= len;
+      }
+    }
+    if (hs->left == 0) {
+      /* We reached the end of the file so this request is done.
+       * When closing, this adds the FIN flag right into the last data
+       * segment. */
+      LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
+      if (!http_end_response(pcb, hs)) {
+        return 0;
+      }
+    }
   }
   LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("send_data end.\n"));
   return data_to_send;
@@ -1667,6 +2289,20 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
       uri_len = sp2 - (sp1 + 1);
       if ((sp2 != 0) && (sp2 > sp1)) {
         char *uri = sp1 + 1;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        /* Keep the connection open for HTTP/1.1 clients unless they ask us
+           to close it. This must be checked before the request is
+           null-terminated since strnstr stops at the first null. */
+        hs->keepalive = !is_09 &&
+          (strnstr(sp2 + 1, "HTTP/1.1", data_len - (sp2 + 1 - data)) == sp2 + 1) &&
+          !http_wants_close(crlf + 2, data_len - (crlf + 2 - data));
+        /* Note where the request ends: a client may send the next request
+           right behind it, even in the same segment */
+        {
+          char *hdr_end = strnstr(crlf, CRLF CRLF, data_len - (crlf - data));
+          hs->req_len = (hdr_end != NULL) ? (u16_t)(hdr_end + 4 - data) : 0;
+        }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
         /* null-terminate the METHOD (pbuf is freed anyway wen returning) */
         *sp1 = 0;
         uri[uri_len] = 0;
@@ -1679,6 +2315,10 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
 #else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
           struct pbuf **q = inp;
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+          /* the data behind the headers is the body, not another request */
+          hs->req_len = 0;
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
           err = http_post_request(pcb, q, hs, data, data_len, uri, sp2);
           if (err != ERR_OK) {
             /* restore header for next try */
@@ -1693,7 +2333,18 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
         } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
         {
+#if LWIP_HTTPD_LATENCY
+          /* Finding the file runs the CGI handler and opens the file; count
+             this as handler rather than parse time */
+          u32_t started = HTTPD_LATENCY_NOW();
+          err_t found = http_find_file(hs, uri, is_09);
+          u32_t handler = HTTPD_LATENCY_NOW() - started;
+          hs->lat_handler += handler;
+          hs->lat_parse -= handler;
+          return found;
+#else /* LWIP_HTTPD_LATENCY */
           return http_find_file(hs, uri, is_09);
+#endif /* LWIP_HTTPD_LATENCY */
         }
       } else {
         LWIP_DEBUGF(HTTPD_DEBUG, ("invalid URI\n"));
@@ -1853,6 +2504,9 @@ http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const cha
 #if LWIP_HTTPD_TIMING
     hs->time_started = sys_now();
 #endif /* LWIP_HTTPD_TIMING */
+#if LWIP_HTTPD_LATENCY
+    hs->lat_route = http_latency_route_find(uri);
+#endif /* LWIP_HTTPD_LATENCY */
 #if !LWIP_HTTPD_DYNAMIC_HEADERS
     LWIP_ASSERT("HTTP headers not included in file system", hs->handle->http_header_included);
 #endif /* !LWIP_HTTPD_DYNAMIC_HEADERS */
@@ -1880,6 +2534,9 @@ http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const cha
   if ((hs->handle == NULL) || !hs->handle->http_header_included) {
     get_http_headers(hs, (char*)uri);
   }
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  http_set_framing(hs, is_09);
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #else /* LWIP_HTTPD_DYNAMIC_HEADERS */
   LWIP_UNUSED_ARG(uri);
 #endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
@@ -1922,6 +2579,18 @@ http_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
 
   hs->retries = 0;
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  if (hs->keepalive && (hs->handle == NULL)) {
+    /* The response is complete, wait for the next request. */
+#if LWIP_HTTPD_LATENCY
+    http_latency_acked(hs, pcb);
+#endif /* LWIP_HTTPD_LATENCY */
+    /* Handle a request that was held back while sending the response */
+    http_recv_pipelined(pcb, hs);
+    return ERR_OK;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
   http_send_data(pcb, hs);
 
   return ERR_OK;
@@ -1962,6 +2631,13 @@ http_poll(void *arg, struct tcp_pcb *pcb)
       return ERR_OK;
     }
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    /* Pick up a pipelined request left waiting after a response */
+    if (http_recv_pipelined(pcb, hs)) {
+      return ERR_OK;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
     /* If this connection has a file open, try to send some more data. If
      * it has not yet received a GET request, don't do this since it will
      * cause the connection to close immediately. */
@@ -1985,7 +2661,6 @@ http_poll(void *arg, struct tcp_pcb *pcb)
 static err_t
 http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 {
-  err_t parsed = ERR_ABRT;
   struct http_state *hs = (struct http_state *)arg;
   LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_recv: pcb=%p pbuf=%p err=%s\n", (void*)pcb,
     (void*)p, lwip_strerr(err)));
@@ -2005,6 +2680,30 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
     return ERR_OK;
   }
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+  if (hs->keepalive &&
+      ((hs->handle != NULL) || (hs->file != NULL) || (hs->pipelined != NULL))
+#if LWIP_HTTPD_SUPPORT_POST
+      && (hs->post_content_len_left == 0)
+#endif /* LWIP_HTTPD_SUPPORT_POST */
+     ) {
+    /* A pipelined request arrived while the response to the previous one is
+       still being sent, or behind one still waiting: hold it back until that
+       response is complete (see http_recv_pipelined). The receive window is
+       only opened once it is handled, so the client can not make us queue
+       more than a window of data. */
+    LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: holding back pipelined request\n"));
+    hs->pipelined_unrecved += p->tot_len;
+    if (hs->pipelined == NULL) {
+      hs->pipelined = p;
+    } else {
+      pbuf_cat(hs->pipelined, p);
+    }
+    http_recv_pipelined(pcb, hs);
+    return ERR_OK;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 #if LWIP_HTTPD_SUPPORT_POST && LWIP_HTTPD_POST_MANUAL_WND
   if (hs->no_auto_wnd) {
      hs->unrecved_bytes += p->tot_len;
@@ -2015,6 +2714,18 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
     tcp_recved(pcb, p->tot_len);
   }
 
+  return http_recv_data(pcb, hs, p);
+}
+
+/**
+ * Handle data received on this pcb once TCP has been told it was taken:
+ * pass it to a POST in progress or parse it as a request.
+ */
+static err_t
+http_recv_data(struct tcp_pcb *pcb, struct http_state *hs, struct pbuf *p)
+{
+  err_t parsed = ERR_ABRT;
+
 #if LWIP_HTTPD_SUPPORT_POST
   if (hs->post_content_len_left > 0) {
     /* reset idle counter when POST data is received */
@@ -2031,24 +2742,50 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 #endif /* LWIP_HTTPD_SUPPORT_POST */
   {
     if (hs->handle == NULL) {
+#if LWIP_HTTPD_LATENCY
+      u32_t started;
+      http_latency_request(hs);
+      started = HTTPD_LATENCY_NOW();
       parsed = http_parse_request(&p, hs, pcb);
+      hs->lat_parse += HTTPD_LATENCY_NOW() - started;
+#else /* LWIP_HTTPD_LATENCY */
+      parsed = http_parse_request(&p, hs, pcb);
+#endif /* LWIP_HTTPD_LATENCY */
       LWIP_ASSERT("http_parse_request: unexpected return value", parsed == ERR_OK
         || parsed == ERR_INPROGRESS ||parsed == ERR_ARG || parsed == ERR_USE);
     } else {
       LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: already sending data\n"));
     }
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
+    if ((parsed == ERR_ABRT) || (parsed == ERR_USE)) {
+      /* p was not added to hs->req, drop it */
+      pbuf_free(p);
+    }
     if (parsed != ERR_INPROGRESS) {
       /* request fully parsed or error */
       if (hs->req != NULL) {
-        pbuf_free(hs->req);
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        if (parsed == ERR_OK) {
+          http_keep_pipelined(hs, hs->req);
+        } else
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+        {
+          pbuf_free(hs->req);
+        }
         hs->req = NULL;
       }
     }
 #else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
     if (p != NULL) {
       /* pbuf not passed to application, free it now */
-      pbuf_free(p);
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+      if (parsed == ERR_OK) {
+        http_keep_pipelined(hs, p);
+      } else
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+      {
+        pbuf_free(p);
+      }
     }
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
     if (parsed == ERR_OK) {
@@ -2091,6 +2828,10 @@ http_accept(void *arg, struct tcp_pcb *pcb, err_t err)
     return ERR_MEM;
   }
 
+#if LWIP_HTTPD_LATENCY
+  hs->lat_accept = HTTPD_LATENCY_NOW();
+#endif /* LWIP_HTTPD_LATENCY */
+
   /* Tell TCP that this is the structure we wish to be passed for our
      callbacks. */
   tcp_arg(pcb, hs);
@@ -2138,6 +2879,10 @@ httpd_init(void)
 #endif
   LWIP_DEBUGF(HTTPD_DEBUG, ("httpd_init\n"));
 
+#if LWIP_HTTPD_LATENCY
+  httpd_latency_reset();
+#endif /* LWIP_HTTPD_LATENCY */
+
   httpd_init_addr(IP_ADDR_ANY);
 }
 
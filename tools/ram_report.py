@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# ram_report.py - Sums the statically allocated RAM of a build by subsystem.
+#
+# Copyright (c) 2014 Texas Instruments Incorporated.  All rights reserved.
+# Software License Agreement
+#
+# Texas Instruments (TI) is supplying this software for use solely and
+# exclusively on TI's microcontroller products. The software is owned by
+# TI and/or its suppliers, and is protected under applicable copyright
+# laws. You may not combine this software with "viral" open-source
+# software in order to form a larger program.
+#
+# THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+# NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+# NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+# CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+# DAMAGES, FOR ANY REASON WHATSOEVER.
+#
+# This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+#
+"""Report the RAM used by a build, by subsystem, from the TI linker's XML
+link information file (Debug/<project>_linkInfo.xml, written when the link
+step is given --xml_link_info).
+
+The buffers sized by the RAM budget profile (see mem_profile.h) are listed on
+their own, followed by the rest of each subsystem:
+
+    python tools/ram_report.py Debug/http_server2_linkInfo.xml
+    python tools/ram_report.py --symbols 5 Debug/http_server2_linkInfo.xml
+"""
+
+import argparse
+import sys
+import xml.etree.ElementTree as ET
+
+# The memory area holding the RAM.
+RAM_AREA = 'SRAM'
+
+# The buffers set by the RAM budget profile, by section name.
+BUDGET_SECTIONS = [
+    ('.bss:ram_heap', 'lwIP heap (MEM_SIZE)'),
+    ('.bss:memp_memory', 'lwIP pools (PBUF_POOL_SIZE, MEMP_NUM_*)'),
+    ('.bss:ucHeap', 'FreeRTOS heap (configTOTAL_HEAP_SIZE)'),
+    ('.bss:g_puxTimeStack', 'task stacks (PROFILE_*_STACK_SIZE)'),
+    ('.bss:g_puxTempStack', 'task stacks (PROFILE_*_STACK_SIZE)'),
+    ('.bss:g_puxDisplayStack', 'task stacks (PROFILE_*_STACK_SIZE)'),
+    ('.bss:g_puxStatusStack', 'task stacks (PROFILE_*_STACK_SIZE)'),
+    ('.bss:g_puxLwIPIntStack', 'task stacks (PROFILE_*_STACK_SIZE)'),
+]
+
+# The subsystems, by the first matching fragment of an input file's path and
+# name; anything else is the application.
+SUBSYSTEMS = [
+    ('third_party/freertos/', 'FreeRTOS'),
+    ('third_party/lwip', 'lwIP'),
+    ('utils/lwiplib', 'lwIP'),
+    ('grlib', 'grlib'),
+    ('driverlib', 'driverlib'),
+    ('sensorlib', 'sensorlib'),
+    ('rtsv7', 'C runtime'),
+    ('./drivers/', 'board drivers'),
+    ('./utils/', 'utils'),
+]
+
+
+def load(path):
+    """Returns the RAM area's origin, length and used space, and a list of
+    (section, bytes, subsystem) for the sections placed in it."""
+    root = ET.parse(path).getroot()
+
+    files = {}
+    for node in root.find('input_file_list'):
+        files[node.get('id')] = ((node.findtext('path') or '') +
+                                 (node.findtext('name') or ''))
+
+    for area in root.iter('memory_area'):
+        if area.findtext('name') == RAM_AREA:
+            origin = int(area.findtext('origin'), 16)
+            length = int(area.findtext('length'), 16)
+            used = int(area.findtext('used_space'), 16)
+            break
+    else:
+        sys.exit('%s: no %s memory area' % (path, RAM_AREA))
+
+    sections = []
+    for node in root.iter('object_component'):
+        address = node.findtext('run_address')
+        size = node.findtext('size')
+        if (address is None) or (size is None):
+            continue
+        address = int(address, 16)
+        size = int(size, 16)
+        if (size == 0) or not (origin <= address < (origin + length)):
+            continue
+
+        name = node.findtext('name')
+        ref = node.find('input_file_ref')
+        source = files.get(ref.get('idref'), '') if ref is not None else ''
+        sections.append((name, size, classify(name, source)))
+
+    return origin, length, used, sections
+
+
+def classify(name, source):
+    """Returns the subsystem of a section."""
+    for section, label in BUDGET_SECTIONS:
+        if name == section:
+            return label
+
+    if not source:
+        # Uninitialized globals merged by the linker, the system stack and
+        # the C heap.
+        return 'linker (%s)' % name.split(':')[0]
+
+    lower = source.lower().replace('\\', '/')
+    for fragment, label in SUBSYSTEMS:
+        if fragment in lower:
+            return label
+    return 'application'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('link_info', help='the linker XML link information')
+    parser.add_argument('--symbols', type=int, default=0, metavar='N',
+                        help='list the N largest sections of each subsystem')
+    args = parser.parse_args()
+
+    origin, length, used, sections = load(args.link_info)
+
+    totals = {}
+    for name, size, subsystem in sections:
+        totals[subsystem] = totals.get(subsystem, 0) + size
+
+    budget = []
+    for _, label in BUDGET_SECTIONS:
+        if (label in totals) and (label not in budget):
+            budget.append(label)
+    rest = sorted((label for label in totals if label not in budget),
+                  key=lambda label: -totals[label])
+
+    print('%s at 0x%08x: %d bytes, %d used (%.1f%%), %d free' %
+          (RAM_AREA, origin, length, used, (100.0 * used) / length,
+           length - used))
+    print('')
+    print('%-42s %8s %6s' % ('Subsystem', 'Bytes', '%'))
+    for label in budget + rest:
+        print('%-42s %8d %6.1f' %
+              (label, totals[label], (100.0 * totals[label]) / length))
+        if args.symbols and label not in budget:
+            largest = sorted((s for s in sections if s[2] == label),
+                             key=lambda s: -s[1])
+            for name, size, _ in largest[:args.symbols]:
+                print('    %-38s %8d' % (name, size))
+
+    # The stack, the C heap and alignment padding are placed without an
+    # object component of their own.
+    other = used - sum(totals.values())
+    if other > 0:
+        print('%-42s %8d %6.1f' %
+              ('stack, C heap and padding', other, (100.0 * other) / length))
+    print('%-42s %8d %6.1f' % ('Total', used, (100.0 * used) / length))
+
+
+if __name__ == '__main__':
+    main()
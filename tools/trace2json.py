@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#
+# trace2json.py - Converts the event trace of the board to a Chrome trace.
+#
+# Copyright (c) 2014 Texas Instruments Incorporated.  All rights reserved.
+# Software License Agreement
+#
+# Texas Instruments (TI) is supplying this software for use solely and
+# exclusively on TI's microcontroller products. The software is owned by
+# TI and/or its suppliers, and is protected under applicable copyright
+# laws. You may not combine this software with "viral" open-source
+# software in order to form a larger program.
+#
+# THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+# NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+# NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+# CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+# DAMAGES, FOR ANY REASON WHATSOEVER.
+#
+# This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+#
+"""Convert the event trace served as /sys/trace (see trace.c) to the Chrome
+trace event format, which chrome://tracing and https://ui.perfetto.dev open.
+
+Each task, and each traced interrupt, gets a track showing when it ran;
+queue, semaphore and mutex operations are marked on the track of the task or
+interrupt that made them:
+
+    python tools/trace2json.py http://192.168.1.10/sys/trace -o trace.json
+    python tools/trace2json.py trace.bin -o trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+import urllib.request
+
+MAGIC = b'TRC1'
+HEADER = struct.Struct('<4sIHHHHI')
+EVENT = struct.Struct('<IHBB')
+
+# The event types of trace.h.
+TASK_IN = 1
+QUEUE_SEND = 2
+QUEUE_RECEIVE = 3
+ISR_ENTER = 4
+ISR_EXIT = 5
+
+# The thread identifiers of the interrupt tracks are offset from the task
+# numbers.
+ISR_TID = 1000
+PID = 1
+
+
+def read(source):
+    """Returns the contents of a file, or of a URL."""
+    if source.startswith('http://') or source.startswith('https://'):
+        with urllib.request.urlopen(source) as response:
+            return response.read()
+    with open(source, 'rb') as f:
+        return f.read()
+
+
+def parse(data):
+    """Returns the timer rate, the task and object names by identifier and a
+    list of (time, type, data) events from a trace file."""
+    if len(data) < HEADER.size:
+        sys.exit('trace too short')
+    (magic, rate, name_len, num_tasks, num_objects, _,
+     num_events) = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit('not a trace (magic %r)' % magic)
+
+    offset = HEADER.size
+    names = []
+    for _ in range(num_tasks + num_objects):
+        ident, = struct.unpack_from('<I', data, offset)
+        name = data[offset + 4:offset + 4 + name_len]
+        names.append((ident, name.split(b'\0')[0].decode('ascii', 'replace')))
+        offset += 4 + name_len
+    tasks = dict(names[:num_tasks])
+    objects = dict(names[num_tasks:])
+
+    events = []
+    for _ in range(num_events):
+        time, value, kind, _ = EVENT.unpack_from(data, offset)
+        events.append((time, kind, value))
+        offset += EVENT.size
+
+    return rate, tasks, objects, events
+
+
+def convert(rate, tasks, objects, events):
+    """Returns the Chrome trace events for a trace."""
+    out = [{'name': 'process_name', 'ph': 'M', 'pid': PID,
+            'args': {'name': 'DK-TM4C129X'}}]
+    threads = {}
+
+    def thread(tid, name):
+        if tid not in threads:
+            threads[tid] = name
+            out.append({'name': 'thread_name', 'ph': 'M', 'pid': PID,
+                        'tid': tid, 'args': {'name': name}})
+        return tid
+
+    def task_name(number):
+        return tasks.get(number, 'task %d' % number)
+
+    def add_slice(name, tid, start, end):
+        out.append({'name': name, 'ph': 'X', 'pid': PID, 'tid': tid,
+                    'ts': start, 'dur': max(end - start, 0)})
+
+    # Times are unwrapped from the 32-bit timer, assuming no two consecutive
+    # events are a whole timer period apart, and given in microseconds from
+    # the first event.
+    ticks = 0
+    last = events[0][0] if events else 0
+
+    task, task_start = None, None
+    isrs = []
+    for time, kind, data in events:
+        ticks += (time - last) & 0xffffffff
+        last = time
+        now = (ticks * 1e6) / rate
+
+        if kind == TASK_IN:
+            if task is not None:
+                add_slice(task_name(task), thread(task, task_name(task)),
+                      task_start, now)
+            task, task_start = data, now
+        elif kind == ISR_ENTER:
+            isrs.append((data, now))
+        elif kind == ISR_EXIT:
+            if isrs and isrs[-1][0] == data:
+                irq, start = isrs.pop()
+                name = 'interrupt %d' % irq
+                add_slice(name, thread(ISR_TID + irq, name), start, now)
+        elif kind in (QUEUE_SEND, QUEUE_RECEIVE):
+            if isrs:
+                irq = isrs[-1][0]
+                tid = thread(ISR_TID + irq, 'interrupt %d' % irq)
+            elif task is not None:
+                tid = thread(task, task_name(task))
+            else:
+                continue
+            name = objects.get(data, 'queue 0x%04x' % data)
+            out.append({'name': ('send ' if kind == QUEUE_SEND
+                                 else 'receive ') + name,
+                        'ph': 'i', 's': 't', 'pid': PID, 'tid': tid,
+                        'ts': now})
+
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('trace', help='the trace file, or the URL of '
+                        '/sys/trace on the board')
+    parser.add_argument('-o', '--output', default='-', metavar='FILE',
+                        help='the JSON file to write (default: stdout)')
+    args = parser.parse_args()
+
+    rate, tasks, objects, events = parse(read(args.trace))
+    trace = {'traceEvents': convert(rate, tasks, objects, events),
+             'displayTimeUnit': 'ns'}
+
+    if args.output == '-':
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f)
+
+
+if __name__ == '__main__':
+    main()
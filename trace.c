@@ -0,0 +1,448 @@
+//*****************************************************************************
+//
+// trace.c - An in-RAM trace of kernel and interrupt events.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "driverlib/cpu.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cpu_load.h"
+#include "fs_gen.h"
+#include "trace.h"
+
+//*****************************************************************************
+//
+// The kernel's trace hooks (see FreeRTOSConfig.h) and the interrupt handlers
+// record events in a ring that always holds the last TRACE_EVENTS of them.
+// Recording an event reads the free-running timer of the CPU load
+// measurement and writes 8 bytes with interrupts disabled, so the trace can be
+// left on.  The timer is used rather than the cycle counter because the
+// latter stops while the core sleeps in tickless idle.
+//
+// Interrupts are disabled outright, rather than masked up to the kernel
+// priority, because some traced handlers run above the kernel priority.
+//
+// /sys/trace serves a copy of the ring, taken when the file is opened, with
+// the names of the tasks and of the objects named by TraceObjectName().  It is
+// little-endian binary:
+//
+//     header:  "TRC1", timer rate in Hz (u32), name length (u16), number of
+//              tasks (u16), number of objects (u16), 0 (u16), number of
+//              events (u32)
+//     tasks:   task number (u32), name (null-padded to the name length)
+//     objects: TRACE_OBJECT_ID() (u32), name (null-padded)
+//     events:  time (u32), data (u16), type (u8), 0 (u8), oldest first
+//
+// tools/trace2json.py converts it to the Chrome trace event format, which
+// chrome://tracing and Perfetto display.
+//
+//*****************************************************************************
+#define TRACE_MAGIC             0x31435254  // "TRC1"
+#define TRACE_HEADER_SIZE       20
+#define TRACE_TASKS_MAX         16
+#define TRACE_PART_EVENTS       32
+#define TRACE_PART_MAX          (TRACE_PART_EVENTS * 8)
+
+#if TRACE_ENABLE
+static tTraceEvent g_psTrace[TRACE_EVENTS];
+static uint32_t g_ui32TraceHead;
+#endif
+
+//*****************************************************************************
+//
+// The named kernel objects.
+//
+//*****************************************************************************
+typedef struct
+{
+    const void *pvObject;
+    const char *pcName;
+}
+tTraceName;
+
+#if TRACE_ENABLE
+static tTraceName g_psTraceNames[TRACE_NAMES_MAX];
+static uint32_t g_ui32TraceNumNames;
+#endif
+
+//*****************************************************************************
+//
+// Records an event.
+//
+//*****************************************************************************
+#if TRACE_ENABLE
+static void
+TraceEvent(uint32_t ui32Type, uint32_t ui32Data)
+{
+    tTraceEvent *psEvent;
+    uint32_t ui32Masked;
+
+    ui32Masked = CPUcpsid();
+    psEvent = &g_psTrace[g_ui32TraceHead++ & (TRACE_EVENTS - 1)];
+    psEvent->ui32Time = CPULoadTimeGet();
+    psEvent->ui16Data = (uint16_t)ui32Data;
+    psEvent->ui8Type = (uint8_t)ui32Type;
+    if(!ui32Masked)
+    {
+        CPUcpsie();
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+// Called by the kernel, through traceTASK_SWITCHED_IN, when a task is
+// switched in.  The switch out of the previous task is not recorded
+// separately, as it happens at the same time.
+//
+//*****************************************************************************
+void
+TraceTaskSwitchedIn(unsigned long ulTask)
+{
+#if TRACE_ENABLE
+    TraceEvent(TRACE_TASK_IN, ulTask);
+#endif
+}
+
+//*****************************************************************************
+//
+// Called by the kernel, through traceQUEUE_SEND and traceQUEUE_RECEIVE and
+// their FromISR versions, when an item is sent to or received from a queue.
+// Semaphores and mutexes are queues, so giving and taking them is recorded
+// too.
+//
+//*****************************************************************************
+void
+TraceQueueSend(void *pvQueue)
+{
+#if TRACE_ENABLE
+    TraceEvent(TRACE_QUEUE_SEND, TRACE_OBJECT_ID(pvQueue));
+#endif
+}
+
+void
+TraceQueueReceive(void *pvQueue)
+{
+#if TRACE_ENABLE
+    TraceEvent(TRACE_QUEUE_RECEIVE, TRACE_OBJECT_ID(pvQueue));
+#endif
+}
+
+//*****************************************************************************
+//
+// Called by a traced interrupt handler on entry and on exit.
+//
+//*****************************************************************************
+void
+TraceISREnter(unsigned long ulInt)
+{
+#if TRACE_ENABLE
+    TraceEvent(TRACE_ISR_ENTER, ulInt);
+#endif
+}
+
+void
+TraceISRExit(unsigned long ulInt)
+{
+#if TRACE_ENABLE
+    TraceEvent(TRACE_ISR_EXIT, ulInt);
+#endif
+}
+
+//*****************************************************************************
+//
+// Names a queue, semaphore or mutex in /sys/trace.  The name is not copied.
+// Must be called before the scheduler is started, or by one task only.
+//
+//*****************************************************************************
+void
+TraceObjectName(const void *pvObject, const char *pcName)
+{
+#if TRACE_ENABLE
+    if(pvObject && (g_ui32TraceNumNames < TRACE_NAMES_MAX))
+    {
+        g_psTraceNames[g_ui32TraceNumNames].pvObject = pvObject;
+        g_psTraceNames[g_ui32TraceNumNames].pcName = pcName;
+        g_ui32TraceNumNames++;
+    }
+#endif
+}
+
+//*****************************************************************************
+//
+// Copies the last ui32Count events, oldest first, and returns the number
+// copied, which is less if fewer have been recorded.  May be called from a
+// fault handler.
+//
+//*****************************************************************************
+uint32_t
+TraceLastGet(tTraceEvent *psEvents, uint32_t ui32Count)
+{
+#if TRACE_ENABLE
+    uint32_t ui32Masked, ui32Idx, ui32First;
+
+    ui32Masked = CPUcpsid();
+    if(ui32Count > TRACE_EVENTS)
+    {
+        ui32Count = TRACE_EVENTS;
+    }
+    if(ui32Count > g_ui32TraceHead)
+    {
+        ui32Count = g_ui32TraceHead;
+    }
+    ui32First = g_ui32TraceHead - ui32Count;
+    for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++)
+    {
+        psEvents[ui32Idx] =
+            g_psTrace[(ui32First + ui32Idx) & (TRACE_EVENTS - 1)];
+    }
+    if(!ui32Masked)
+    {
+        CPUcpsie();
+    }
+
+    return(ui32Count);
+#else
+    return(0);
+#endif
+}
+
+#if TRACE_ENABLE
+//*****************************************************************************
+//
+// The state of an open /sys/trace.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The encoded part being sent, how much of it is sent, and the index of
+    // the next part.
+    //
+    uint8_t pui8Buf[TRACE_PART_MAX];
+    int iLen;
+    int iPos;
+    uint32_t ui32Part;
+
+    //
+    // The tasks, the named objects and the events when the file was opened.
+    //
+    uint32_t ui32NumTasks;
+    xTaskStatusType psTasks[TRACE_TASKS_MAX];
+    uint32_t ui32NumNames;
+    tTraceName psNames[TRACE_NAMES_MAX];
+    uint32_t ui32NumEvents;
+    tTraceEvent psEvents[TRACE_EVENTS];
+}
+tTraceFile;
+
+//*****************************************************************************
+//
+// Little-endian field writers for the file.
+//
+//*****************************************************************************
+static uint8_t *
+Put16(uint8_t *pui8Buf, uint32_t ui32Val)
+{
+    pui8Buf[0] = (uint8_t)ui32Val;
+    pui8Buf[1] = (uint8_t)(ui32Val >> 8);
+    return(pui8Buf + 2);
+}
+
+static uint8_t *
+Put32(uint8_t *pui8Buf, uint32_t ui32Val)
+{
+    pui8Buf[0] = (uint8_t)ui32Val;
+    pui8Buf[1] = (uint8_t)(ui32Val >> 8);
+    pui8Buf[2] = (uint8_t)(ui32Val >> 16);
+    pui8Buf[3] = (uint8_t)(ui32Val >> 24);
+    return(pui8Buf + 4);
+}
+
+static uint8_t *
+PutName(uint8_t *pui8Buf, const char *pcName)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < configMAX_TASK_NAME_LEN; ui32Idx++)
+    {
+        pui8Buf[ui32Idx] = *pcName;
+        if(*pcName)
+        {
+            pcName++;
+        }
+    }
+    pui8Buf[configMAX_TASK_NAME_LEN - 1] = 0;
+
+    return(pui8Buf + configMAX_TASK_NAME_LEN);
+}
+
+//*****************************************************************************
+//
+// Encodes the next part of /sys/trace: the header, one part per task and per
+// named object, then the events TRACE_PART_EVENTS at a time.  Returns false
+// once there are no more parts.
+//
+//*****************************************************************************
+static bool
+TraceFileNext(tTraceFile *psFile)
+{
+    uint8_t *pui8Buf = psFile->pui8Buf;
+    tTraceEvent *psEvent;
+    uint32_t ui32Part, ui32Idx, ui32Count;
+
+    ui32Part = psFile->ui32Part++;
+
+    if(ui32Part == 0)
+    {
+        pui8Buf = Put32(pui8Buf, TRACE_MAGIC);
+        pui8Buf = Put32(pui8Buf, CPULoadTimeRateGet());
+        pui8Buf = Put16(pui8Buf, configMAX_TASK_NAME_LEN);
+        pui8Buf = Put16(pui8Buf, psFile->ui32NumTasks);
+        pui8Buf = Put16(pui8Buf, psFile->ui32NumNames);
+        pui8Buf = Put16(pui8Buf, 0);
+        pui8Buf = Put32(pui8Buf, psFile->ui32NumEvents);
+    }
+    else if(ui32Part <= psFile->ui32NumTasks)
+    {
+        ui32Idx = ui32Part - 1;
+        pui8Buf = Put32(pui8Buf, psFile->psTasks[ui32Idx].xTaskNumber);
+        pui8Buf = PutName(pui8Buf,
+                          (const char *)psFile->psTasks[ui32Idx].pcTaskName);
+    }
+    else if(ui32Part <= (psFile->ui32NumTasks + psFile->ui32NumNames))
+    {
+        ui32Idx = ui32Part - psFile->ui32NumTasks - 1;
+        pui8Buf = Put32(pui8Buf,
+                        TRACE_OBJECT_ID(psFile->psNames[ui32Idx].pvObject));
+        pui8Buf = PutName(pui8Buf, psFile->psNames[ui32Idx].pcName);
+    }
+    else
+    {
+        ui32Idx = ((ui32Part - psFile->ui32NumTasks - psFile->ui32NumNames -
+                    1) * TRACE_PART_EVENTS);
+        if(ui32Idx >= psFile->ui32NumEvents)
+        {
+            return(false);
+        }
+
+        ui32Count = psFile->ui32NumEvents - ui32Idx;
+        if(ui32Count > TRACE_PART_EVENTS)
+        {
+            ui32Count = TRACE_PART_EVENTS;
+        }
+
+        for(psEvent = &psFile->psEvents[ui32Idx]; ui32Count; ui32Count--)
+        {
+            pui8Buf = Put32(pui8Buf, psEvent->ui32Time);
+            pui8Buf = Put16(pui8Buf, psEvent->ui16Data);
+            *pui8Buf++ = psEvent->ui8Type;
+            *pui8Buf++ = 0;
+            psEvent++;
+        }
+    }
+
+    psFile->iPos = 0;
+    psFile->iLen = pui8Buf - psFile->pui8Buf;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Produces the next block of /sys/trace.
+//
+//*****************************************************************************
+static int
+TraceFileRead(void *pvState, char *pcBuf, int iCount)
+{
+    tTraceFile *psFile = pvState;
+    int iCopied, iLen;
+
+    for(iCopied = 0; iCopied < iCount; iCopied += iLen)
+    {
+        //
+        // Encode the next part once the current one has been sent.
+        //
+        while(psFile->iPos == psFile->iLen)
+        {
+            if(!TraceFileNext(psFile))
+            {
+                return((iCopied == 0) ? FS_GEN_EOF : iCopied);
+            }
+        }
+
+        iLen = psFile->iLen - psFile->iPos;
+        if(iLen > (iCount - iCopied))
+        {
+            iLen = iCount - iCopied;
+        }
+        memcpy(pcBuf + iCopied, psFile->pui8Buf + psFile->iPos, iLen);
+        psFile->iPos += iLen;
+    }
+
+    return(iCopied);
+}
+
+//*****************************************************************************
+//
+// Opens /sys/trace, taking a copy of the ring and of the names.
+//
+//*****************************************************************************
+static void
+TraceFileOpen(void *pvState)
+{
+    tTraceFile *psFile = pvState;
+
+    psFile->ui32NumEvents = TraceLastGet(psFile->psEvents, TRACE_EVENTS);
+    psFile->ui32NumTasks = uxTaskGetSystemState(psFile->psTasks,
+                                                TRACE_TASKS_MAX, NULL);
+    psFile->ui32NumNames = g_ui32TraceNumNames;
+    memcpy(psFile->psNames, g_psTraceNames, sizeof(g_psTraceNames));
+}
+
+//*****************************************************************************
+//
+// The trace file.
+//
+//*****************************************************************************
+static const tFSGenerator g_sTraceFile =
+{
+    "/sys/trace", sizeof(tTraceFile), TraceFileOpen, TraceFileRead
+};
+#endif
+
+//*****************************************************************************
+//
+// Registers the trace file with the web server file system.
+//
+//*****************************************************************************
+void
+TraceFilesRegister(void)
+{
+#if TRACE_ENABLE
+    FSGenRegister(&g_sTraceFile);
+#endif
+}
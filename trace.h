@@ -0,0 +1,99 @@
+//*****************************************************************************
+//
+// trace.h - An in-RAM trace of kernel and interrupt events.
+//
+// Copyright (c) 2009-2014 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.1.0.12573 of the DK-TM4C129X Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+//*****************************************************************************
+//
+// Set TRACE_ENABLE to 0 to remove the trace; the hooks are then empty and
+// /sys/trace is not served.
+//
+//*****************************************************************************
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE            1
+#endif
+
+//*****************************************************************************
+//
+// The number of events the ring holds; must be a power of two.  Each takes 8
+// bytes.
+//
+//*****************************************************************************
+#define TRACE_EVENTS            512
+
+//*****************************************************************************
+//
+// The largest number of kernel objects that can be given names.
+//
+//*****************************************************************************
+#define TRACE_NAMES_MAX         8
+
+//*****************************************************************************
+//
+// The event types, and what the data of each is.
+//
+//*****************************************************************************
+#define TRACE_TASK_IN           1       // The task number.
+#define TRACE_QUEUE_SEND        2       // The queue, by TRACE_OBJECT_ID().
+#define TRACE_QUEUE_RECEIVE     3       // The queue, by TRACE_OBJECT_ID().
+#define TRACE_ISR_ENTER         4       // The interrupt number.
+#define TRACE_ISR_EXIT          5       // The interrupt number.
+
+//*****************************************************************************
+//
+// The 16-bit identifier of a kernel object in the SRAM: its word offset.
+//
+//*****************************************************************************
+#define TRACE_OBJECT_ID(p)      ((uint16_t)(((uint32_t)(p) - 0x20000000) >> 2))
+
+//*****************************************************************************
+//
+// An event.  The time is that of CPULoadTimeGet(), in system clock ticks.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Time;
+    uint16_t ui16Data;
+    uint8_t ui8Type;
+    uint8_t ui8Reserved;
+}
+tTraceEvent;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void TraceTaskSwitchedIn(unsigned long ulTask);
+extern void TraceQueueSend(void *pvQueue);
+extern void TraceQueueReceive(void *pvQueue);
+extern void TraceISREnter(unsigned long ulInt);
+extern void TraceISRExit(unsigned long ulInt);
+extern void TraceObjectName(const void *pvObject, const char *pcName);
+extern uint32_t TraceLastGet(tTraceEvent *psEvents, uint32_t ui32Count);
+extern void TraceFilesRegister(void);
+
+#endif // __TRACE_H__
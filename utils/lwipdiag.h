@@ -0,0 +1,237 @@
+//*****************************************************************************
+//
+// lwipdiag.h - Diagnostics of the lwIP TCP/IP Library Abstraction Layer.
+//
+// Copyright (c) 2007-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.0.1.11577 of the Tiva Utility Library.
+//
+//*****************************************************************************
+
+#ifndef __LWIPDIAG_H__
+#define __LWIPDIAG_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Latency histograms.  Bucket 0 counts intervals shorter than
+// 2^LWIP_LATENCY_MIN_SHIFT ticks of the timer given by LWIP_LATENCY_NOW(),
+// bucket n counts intervals from 2^(LWIP_LATENCY_MIN_SHIFT + n - 1) ticks up
+// to twice that, and the last bucket also counts everything longer.
+//
+//*****************************************************************************
+#define LWIP_LATENCY_MIN_SHIFT  8
+#define LWIP_LATENCY_BUCKETS    16
+
+typedef struct
+{
+    //
+    // The number of intervals recorded and the longest of them.
+    //
+    uint32_t ui32Count;
+    uint32_t ui32Max;
+
+    //
+    // The number of intervals in each bucket.
+    //
+    uint32_t pui32Hist[LWIP_LATENCY_BUCKETS];
+}
+tLwIPLatency;
+
+//*****************************************************************************
+//
+// Receive interrupt coalescing statistics.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The number of times the interrupt task woke to receive packets, and
+    // the number of times it polled for more without an interrupt.
+    //
+    uint32_t ui32Wakeups;
+    uint32_t ui32Polls;
+
+    //
+    // The number of packets passed to the TCP/IP thread and of the batches
+    // they were passed in.
+    //
+    uint32_t ui32Packets;
+    uint32_t ui32Batches;
+
+    //
+    // The number of times the budget or the ring ran out, leaving the
+    // receive interrupt disabled until the TCP/IP thread caught up.
+    //
+    uint32_t ui32Throttled;
+
+    //
+    // The number of packets dropped because the ring was full.
+    //
+    uint32_t ui32Dropped;
+
+    //
+    // The number of times a batch could not be posted because the TCP/IP
+    // thread's mailbox was full, and had to be tried again.
+    //
+    uint32_t ui32Retries;
+}
+tLwIPRxStats;
+
+//*****************************************************************************
+//
+// The memory pools reported by lwIPNetStatsGet(), indexing psPools.
+//
+//*****************************************************************************
+#define LWIP_POOL_PBUF          0
+#define LWIP_POOL_PBUF_POOL     1
+#define LWIP_POOL_TCP_PCB       2
+#define LWIP_POOL_TCP_PCB_LISTEN 3
+#define LWIP_POOL_TCP_SEG       4
+#define LWIP_POOL_SYS_TIMEOUT   5
+#define LWIP_POOL_TCPIP_MSG_API 6
+#define LWIP_NUM_POOLS          7
+
+//*****************************************************************************
+//
+// The use of the heap (in bytes) or of a memory pool (in entries).
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The size, the amount in use and the most ever in use.
+    //
+    uint32_t ui32Avail;
+    uint32_t ui32Used;
+    uint32_t ui32Max;
+
+    //
+    // The number of allocations that failed.
+    //
+    uint32_t ui32Err;
+}
+tLwIPMemStats;
+
+//*****************************************************************************
+//
+// The packet counts of a protocol layer.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The packets sent, received and dropped.
+    //
+    uint32_t ui32Xmit;
+    uint32_t ui32Recv;
+    uint32_t ui32Drop;
+
+    //
+    // The errors: bad checksum, bad length, out of memory, no route, protocol
+    // error, bad option and other.
+    //
+    uint32_t ui32ChkErr;
+    uint32_t ui32LenErr;
+    uint32_t ui32MemErr;
+    uint32_t ui32RtErr;
+    uint32_t ui32ProtErr;
+    uint32_t ui32OptErr;
+    uint32_t ui32Err;
+}
+tLwIPProtoStats;
+
+//*****************************************************************************
+//
+// The use of a DMA descriptor ring: descriptors queued for transmission, or
+// holding received frames not yet passed to the stack.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The number of descriptors, those in use and the most seen in use.
+    //
+    uint32_t ui32Size;
+    uint32_t ui32Used;
+    uint32_t ui32Max;
+
+    //
+    // The number of times the ring ran out of descriptors.
+    //
+    uint32_t ui32Full;
+}
+tLwIPRingStats;
+
+//*****************************************************************************
+//
+// The network stack statistics, from lwIP's lwip_stats and the Ethernet
+// driver.  Counts that lwIP is not configured to keep read as zero.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The heap (MEM_SIZE) and the memory pools.
+    //
+    tLwIPMemStats sHeap;
+    tLwIPMemStats psPools[LWIP_NUM_POOLS];
+
+    //
+    // The Ethernet link, IP and TCP layers.
+    //
+    tLwIPProtoStats sLink;
+    tLwIPProtoStats sIP;
+    tLwIPProtoStats sTCP;
+
+    //
+    // The transmit and receive descriptor rings.
+    //
+    tLwIPRingStats sTxRing;
+    tLwIPRingStats sRxRing;
+}
+tLwIPNetStats;
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void lwIPInputLatencyGet(tLwIPLatency *psLatency);
+extern void lwIPRxStatsGet(tLwIPRxStats *psStats);
+extern void lwIPNetStatsGet(tLwIPNetStats *psStats);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LWIPDIAG_H__
@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "utils/lwiplib.h"
+#include "utils/lwipdiag.h"
 
 //*****************************************************************************
 //
@@ -226,6 +227,71 @@ extern void lwIPHostTimerHandler(void);
 //*****************************************************************************
 static struct netif g_sNetIF;
 
+//*****************************************************************************
+//
+// The use of the Ethernet driver's transmit and receive descriptor rings,
+// sampled each time the Ethernet interrupt is serviced.
+//
+//*****************************************************************************
+static tLwIPRingStats g_sTxRing;
+static tLwIPRingStats g_sRxRing;
+
+//*****************************************************************************
+//
+// Counts the descriptors of a ring whose ownership bit matches bOwned.
+//
+//*****************************************************************************
+static uint32_t
+lwIPRingCount(const tDescriptor *psDesc, uint32_t ui32Num, uint32_t ui32Own,
+              bool bOwned)
+{
+    uint32_t ui32Idx, ui32Count;
+
+    ui32Count = 0;
+    for(ui32Idx = 0; ui32Idx < ui32Num; ui32Idx++)
+    {
+        if(((psDesc[ui32Idx].Desc.ui32CtrlStatus & ui32Own) != 0) == bOwned)
+        {
+            ui32Count++;
+        }
+    }
+
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+// Samples the use of the descriptor rings before the driver services the
+// given interrupt status.  Transmit descriptors are in use while the DMA owns
+// them; receive descriptors once the DMA has handed them back with a frame.
+//
+//*****************************************************************************
+static void
+lwIPRingSample(uint32_t ui32Status)
+{
+    g_sTxRing.ui32Used = lwIPRingCount(g_pTxDescriptors, NUM_TX_DESCRIPTORS,
+                                       DES0_TX_CTRL_OWN, true);
+    if(g_sTxRing.ui32Used > g_sTxRing.ui32Max)
+    {
+        g_sTxRing.ui32Max = g_sTxRing.ui32Used;
+    }
+    if(g_sTxRing.ui32Used == NUM_TX_DESCRIPTORS)
+    {
+        g_sTxRing.ui32Full++;
+    }
+
+    g_sRxRing.ui32Used = lwIPRingCount(g_pRxDescriptors, NUM_RX_DESCRIPTORS,
+                                       DES0_RX_CTRL_OWN, false);
+    if(g_sRxRing.ui32Used > g_sRxRing.ui32Max)
+    {
+        g_sRxRing.ui32Max = g_sRxRing.ui32Used;
+    }
+    if(ui32Status & EMAC_INT_RX_NO_BUFFER)
+    {
+        g_sRxRing.ui32Full++;
+    }
+}
+
 //*****************************************************************************
 //
 // The application's interrupt handler for hardware timer events from the MAC.
@@ -375,21 +441,375 @@ static uint32_t g_ui32GWAddr;
 
 //*****************************************************************************
 //
-// The stack size for the interrupt task.
+// The stack size for the interrupt task, in words.
 //
 //*****************************************************************************
-#if !NO_SYS
+#if !NO_SYS && !defined(STACKSIZE_LWIPINTTASK)
 #define STACKSIZE_LWIPINTTASK   128
 #endif
 
 //*****************************************************************************
 //
-// The handle for the "queue" (semaphore) used to signal the interrupt task
-// from the interrupt handler.
+// The stack of the interrupt task, allocated statically so that only its
+// task control block comes from the RTOS heap.
+//
+//*****************************************************************************
+#if !NO_SYS && RTOS_FREERTOS
+static portSTACK_TYPE g_puxLwIPIntStack[STACKSIZE_LWIPINTTASK];
+#endif
+
+//*****************************************************************************
+//
+// The priority of the interrupt task.  By default it is above the TCP/IP
+// thread, so that received packets are queued for the stack and transmitted
+// buffers are freed as soon as the hardware reports them, whatever the
+// application tasks are doing.  The TCP/IP thread must in turn be above any
+// application task that may run for long if the network is to stay
+// responsive; see TCPIP_THREAD_PRIO.
+//
+//*****************************************************************************
+#if !NO_SYS && !defined(LWIP_INTERRUPT_TASK_PRIO)
+#define LWIP_INTERRUPT_TASK_PRIO                                              \
+                                (TCPIP_THREAD_PRIO + 1)
+#endif
+
+//*****************************************************************************
+//
+// The interrupt handler passes the interrupt status to the interrupt task by
+// ORing it into g_ui32IntStatus and giving the semaphore.  The task takes
+// the accumulated status as a whole, so events reported while it is busy are
+// never lost, however many interrupts occur before it runs again.
+//
+//*****************************************************************************
+#if !NO_SYS
+static xSemaphoreHandle g_pInterrupt;
+static volatile uint32_t g_ui32IntStatus;
+#endif
+
+//*****************************************************************************
+//
+// Set LWIP_RX_COALESCE to coalesce receive interrupts.  The receive interrupt
+// is then disabled when it occurs, and the interrupt task keeps polling the
+// receive descriptors for as long as packets keep arriving, up to
+// LWIP_RX_BUDGET packets per wake-up.  Received packets are queued in a ring
+// of LWIP_RX_RING_SIZE entries (a power of two) and handed to the TCP/IP
+// thread in batches, with one message per batch rather than per packet.
+// Once the budget is spent, or the ring has no room for another full set of
+// receive descriptors, the receive interrupt stays disabled until the TCP/IP
+// thread has processed the batch, so that a flood of packets cannot starve
+// the TCP/IP thread or the tasks below it.  If the TCP/IP thread's mailbox
+// is full when a batch is ready, the interrupt task tries again every
+// LWIP_RX_RETRY_TICKS ticks until it can be posted.
+//
+//*****************************************************************************
+#ifndef LWIP_RX_COALESCE
+#define LWIP_RX_COALESCE        0
+#endif
+
+#ifndef LWIP_RX_BUDGET
+#define LWIP_RX_BUDGET          16
+#endif
+
+#ifndef LWIP_RX_RING_SIZE
+#define LWIP_RX_RING_SIZE       32
+#endif
+
+#ifndef LWIP_RX_RETRY_TICKS
+#define LWIP_RX_RETRY_TICKS     1
+#endif
+
+#if LWIP_RX_COALESCE && (LWIP_RX_RING_SIZE & (LWIP_RX_RING_SIZE - 1))
+#error "LWIP_RX_RING_SIZE must be a power of two"
+#endif
+
+#if !NO_SYS && LWIP_RX_COALESCE
+static struct pbuf *g_ppsRxRing[LWIP_RX_RING_SIZE];
+static volatile uint32_t g_ui32RxHead;
+static volatile uint32_t g_ui32RxTail;
+static volatile bool g_bRxPending;
+static volatile bool g_bRxThrottled;
+static struct tcpip_callback_msg *g_psRxMsg;
+static uint32_t g_ui32RxPolled;
+static tLwIPRxStats g_sRxStats;
+#endif
+
+//*****************************************************************************
+//
+// The Ethernet interrupts that the interrupt handler disables until the
+// interrupt task has serviced them.
+//
+//*****************************************************************************
+#if !NO_SYS
+#if LWIP_RX_COALESCE
+#define LWIP_INT_DEFERRED       (EMAC_INT_RECEIVE | EMAC_INT_TX_STOPPED |     \
+                                 EMAC_INT_RX_NO_BUFFER | EMAC_INT_RX_STOPPED |\
+                                 EMAC_INT_PHY)
+#else
+#define LWIP_INT_DEFERRED       (EMAC_INT_TX_STOPPED | EMAC_INT_RX_NO_BUFFER |\
+                                 EMAC_INT_RX_STOPPED | EMAC_INT_PHY)
+#endif
+#endif
+
+//*****************************************************************************
+//
+// Set LWIP_INPUT_LATENCY to measure the time from the interrupt that reports
+// a received packet to the packet being passed to tcpip_input(), using the
+// free-running timer read by LWIP_LATENCY_NOW().  The first packet received
+// after each receive interrupt is measured.
+//
+//*****************************************************************************
+#ifndef LWIP_INPUT_LATENCY
+#define LWIP_INPUT_LATENCY      0
+#endif
+
+#if LWIP_INPUT_LATENCY && !defined(LWIP_LATENCY_NOW)
+#error "LWIP_INPUT_LATENCY requires LWIP_LATENCY_NOW() to be defined"
+#endif
+
+//*****************************************************************************
+//
+// LWIP_INT_ENTER() and LWIP_INT_EXIT() are called with the interrupt number on
+// entry to and exit from the Ethernet interrupt handler, for example to trace
+// it.
+//
+//*****************************************************************************
+#ifndef LWIP_INT_ENTER
+#define LWIP_INT_ENTER(ui32Int)
+#endif
+#ifndef LWIP_INT_EXIT
+#define LWIP_INT_EXIT(ui32Int)
+#endif
+
+#if !NO_SYS && LWIP_INPUT_LATENCY
+static volatile bool g_bInputStamped;
+static volatile uint32_t g_ui32InputStamp;
+static tLwIPLatency g_sInputLatency;
+#endif
+
+//*****************************************************************************
+//
+// Adds an interval to a latency histogram.
+//
+//*****************************************************************************
+#if !NO_SYS && LWIP_INPUT_LATENCY
+static void
+lwIPLatencyRecord(tLwIPLatency *psLatency, uint32_t ui32Ticks)
+{
+    uint32_t ui32Scaled, ui32Bucket;
+
+    ui32Scaled = ui32Ticks >> LWIP_LATENCY_MIN_SHIFT;
+    for(ui32Bucket = 0;
+        (ui32Scaled != 0) && (ui32Bucket < (LWIP_LATENCY_BUCKETS - 1));
+        ui32Bucket++)
+    {
+        ui32Scaled >>= 1;
+    }
+
+    psLatency->ui32Count++;
+    psLatency->pui32Hist[ui32Bucket]++;
+    if(ui32Ticks > psLatency->ui32Max)
+    {
+        psLatency->ui32Max = ui32Ticks;
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+// Re-enables Ethernet interrupts from a task.  The interrupt handler may be
+// disabling others meanwhile.
 //
 //*****************************************************************************
 #if !NO_SYS
-static xQueueHandle g_pInterrupt;
+static void
+lwIPIntEnable(uint32_t ui32Ints)
+{
+    taskENTER_CRITICAL();
+    MAP_EMACIntEnable(EMAC0_BASE, ui32Ints);
+    taskEXIT_CRITICAL();
+}
+#endif
+
+//*****************************************************************************
+//
+// Processes the batch of received packets in the ring.  This runs in the
+// TCP/IP thread and does for each packet what tcpip_input() would.
+//
+//*****************************************************************************
+#if !NO_SYS && LWIP_RX_COALESCE
+static void
+lwIPRxBatch(void *pvArg)
+{
+    struct pbuf *p;
+
+    //
+    // Packets queued from now on need another batch.
+    //
+    g_bRxPending = false;
+
+    while(g_ui32RxTail != g_ui32RxHead)
+    {
+        p = g_ppsRxRing[g_ui32RxTail & (LWIP_RX_RING_SIZE - 1)];
+        g_ui32RxTail++;
+        ethernet_input(p, &g_sNetIF);
+    }
+
+    //
+    // If the interrupt task ran out of budget, let it receive again.
+    //
+    if(g_bRxThrottled)
+    {
+        g_bRxThrottled = false;
+        lwIPIntEnable(EMAC_INT_RECEIVE);
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+// Hands the packets in the ring to the TCP/IP thread, unless a batch is
+// already waiting for it.
+//
+//*****************************************************************************
+#if !NO_SYS && LWIP_RX_COALESCE
+static void
+lwIPRxFlush(void)
+{
+    if(g_bRxPending ||
+       ((g_ui32RxHead == g_ui32RxTail) && !g_bRxThrottled))
+    {
+        return;
+    }
+
+    g_bRxPending = true;
+    if(tcpip_trycallback(g_psRxMsg) == ERR_OK)
+    {
+        g_sRxStats.ui32Batches++;
+        return;
+    }
+
+    //
+    // The TCP/IP thread's mailbox is full.  The interrupt task tries again
+    // shortly (or after the next packet, if sooner); do not leave receiving
+    // disabled meanwhile.
+    //
+    g_sRxStats.ui32Retries++;
+    g_bRxPending = false;
+    if(g_bRxThrottled)
+    {
+        g_bRxThrottled = false;
+        lwIPIntEnable(EMAC_INT_RECEIVE);
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+// Adds a received packet to the ring.
+//
+//*****************************************************************************
+#if !NO_SYS && LWIP_RX_COALESCE
+static err_t
+lwIPRxQueue(struct pbuf *p)
+{
+    if((g_ui32RxHead - g_ui32RxTail) == LWIP_RX_RING_SIZE)
+    {
+        g_sRxStats.ui32Dropped++;
+        return(ERR_MEM);
+    }
+
+    g_ppsRxRing[g_ui32RxHead & (LWIP_RX_RING_SIZE - 1)] = p;
+    g_ui32RxHead++;
+    g_ui32RxPolled++;
+    g_sRxStats.ui32Packets++;
+
+    return(ERR_OK);
+}
+#endif
+
+//*****************************************************************************
+//
+// Services received packets after a receive interrupt, polling the receive
+// descriptors again for as long as the budget allows and packets keep
+// arriving.  Re-enables the receive interrupt unless the budget is spent.
+//
+//*****************************************************************************
+#if !NO_SYS && LWIP_RX_COALESCE
+static void
+lwIPRxPoll(void)
+{
+    uint32_t ui32Status;
+
+    g_sRxStats.ui32Wakeups++;
+
+    while((g_ui32RxPolled < LWIP_RX_BUDGET) &&
+          ((LWIP_RX_RING_SIZE - (g_ui32RxHead - g_ui32RxTail)) >=
+           NUM_RX_DESCRIPTORS))
+    {
+        //
+        // Let the TCP/IP thread start on the packets so far, should it be
+        // of higher priority.
+        //
+        lwIPRxFlush();
+
+        //
+        // Stop once no more packets have been received.  A packet arriving
+        // after this check leaves the receive interrupt pending, so it is
+        // taken as soon as the interrupt is enabled.
+        //
+        ui32Status = MAP_EMACIntStatus(EMAC0_BASE, false) & EMAC_INT_RECEIVE;
+        if(ui32Status == 0)
+        {
+            lwIPIntEnable(EMAC_INT_RECEIVE);
+            return;
+        }
+
+        MAP_EMACIntClear(EMAC0_BASE, ui32Status);
+        g_sRxStats.ui32Polls++;
+        lwIPRingSample(ui32Status);
+        tivaif_interrupt(&g_sNetIF, ui32Status);
+    }
+
+    //
+    // Out of budget, or of room in the ring.  The TCP/IP thread re-enables
+    // the receive interrupt once it has processed the batch.
+    //
+    g_sRxStats.ui32Throttled++;
+    g_bRxThrottled = true;
+    lwIPRxFlush();
+}
+#endif
+
+//*****************************************************************************
+//
+// Passes a received packet to the TCP/IP thread, measuring the input latency.
+// This is the input function of the network interface when using a RTOS.
+//
+//*****************************************************************************
+#if !NO_SYS
+static err_t
+lwIPTCPIPInput(struct pbuf *p, struct netif *psNetif)
+{
+#if LWIP_INPUT_LATENCY
+    uint32_t ui32Stamp;
+
+    if(g_bInputStamped)
+    {
+        taskENTER_CRITICAL();
+        ui32Stamp = g_ui32InputStamp;
+        g_bInputStamped = false;
+        taskEXIT_CRITICAL();
+
+        lwIPLatencyRecord(&g_sInputLatency, LWIP_LATENCY_NOW() - ui32Stamp);
+    }
+#endif
+
+#if LWIP_RX_COALESCE
+    return(lwIPRxQueue(p));
+#else
+    return(tcpip_input(p, psNetif));
+#endif
+}
 #endif
 
 //*****************************************************************************
@@ -402,30 +822,83 @@ static xQueueHandle g_pInterrupt;
 static void
 lwIPInterruptTask(void *pvArg)
 {
+    uint32_t ui32Status;
+    portTickType xWait;
+
     //
     // Loop forever.
     //
     while(1)
     {
         //
-        // Wait until the semaphore has been signaled.
+        // Wait until the semaphore has been signaled.  While packets are left
+        // in the ring without a batch posted for them, because the TCP/IP
+        // thread's mailbox was full, wake up shortly to post it again: the
+        // last packets of a burst would otherwise wait for the next one.
         //
-        while(xQueueReceive(g_pInterrupt, &pvArg, portMAX_DELAY) != pdPASS)
+        while(1)
         {
+#if LWIP_RX_COALESCE
+            xWait = (((g_ui32RxHead != g_ui32RxTail) && !g_bRxPending) ?
+                     LWIP_RX_RETRY_TICKS : portMAX_DELAY);
+#else
+            xWait = portMAX_DELAY;
+#endif
+            if(xSemaphoreTake(g_pInterrupt, xWait) == pdPASS)
+            {
+                break;
+            }
+#if LWIP_RX_COALESCE
+            lwIPRxFlush();
+#endif
+        }
+
+        //
+        // Take all of the interrupt status reported since the last time.
+        //
+        taskENTER_CRITICAL();
+        ui32Status = g_ui32IntStatus;
+        g_ui32IntStatus = 0;
+        taskEXIT_CRITICAL();
+
+        if(ui32Status == 0)
+        {
+            continue;
         }
 
         //
         // Processes any packets waiting to be sent or received.
         //
-        tivaif_interrupt(&g_sNetIF, (uint32_t)pvArg);
+#if LWIP_RX_COALESCE
+        g_ui32RxPolled = 0;
+#endif
+        lwIPRingSample(ui32Status);
+        tivaif_interrupt(&g_sNetIF, ui32Status);
+
+        //
+        // If packets were received, keep polling for more before enabling
+        // the receive interrupt again.
+        //
+#if LWIP_RX_COALESCE
+        if(ui32Status & EMAC_INT_RECEIVE)
+        {
+            lwIPRxPoll();
+            ui32Status &= ~EMAC_INT_RECEIVE;
+        }
+        else
+        {
+            lwIPRxFlush();
+        }
+#endif
 
         //
-        // Re-enable the Ethernet interrupts.
+        // Re-enable the interrupts that the interrupt handler disabled until
+        // they had been serviced.
         //
-        MAP_EMACIntEnable(EMAC0_BASE, (EMAC_INT_RECEIVE | EMAC_INT_TRANSMIT |
-                                       EMAC_INT_TX_STOPPED |
-                                       EMAC_INT_RX_NO_BUFFER |
-                                       EMAC_INT_RX_STOPPED | EMAC_INT_PHY));
+        if(ui32Status & LWIP_INT_DEFERRED)
+        {
+            lwIPIntEnable(ui32Status & LWIP_INT_DEFERRED);
+        }
     }
 }
 #endif
@@ -463,6 +936,18 @@ lwIPLinkDetect(void)
     //
     g_bLinkActive = bHaveLink;
 
+    //
+    // lwIPLocalIPAddrGet() reports the link state as well as the address, so
+    // tell the status callback about the change even if the address does not
+    // change.
+    //
+#if LWIP_NETIF_STATUS_CALLBACK
+    if(g_sNetIF.status_callback)
+    {
+        g_sNetIF.status_callback(&g_sNetIF);
+    }
+#endif
+
     //
     // Clear any address information from the network interface.
     //
@@ -709,23 +1194,31 @@ lwIPPrivateInit(void *pvArg)
 #endif
 
     //
-    // If using a RTOS, create a queue (to be used as a semaphore) to signal
-    // the Ethernet interrupt task from the Ethernet interrupt handler.
+    // If using a RTOS, create a semaphore to signal the Ethernet interrupt
+    // task from the Ethernet interrupt handler.
     //
 #if !NO_SYS
 #if RTOS_FREERTOS
-    g_pInterrupt = xQueueCreate(1, sizeof(void *));
+    vSemaphoreCreateBinary(g_pInterrupt);
 #endif
 #endif
 
+    //
+    // If coalescing receive interrupts, allocate the message that hands
+    // batches of packets to the TCP/IP thread.
+    //
+#if !NO_SYS && LWIP_RX_COALESCE
+    g_psRxMsg = tcpip_callbackmsg_new(lwIPRxBatch, 0);
+#endif
+
     //
     // If using a RTOS, create the Ethernet interrupt task.
     //
 #if !NO_SYS
 #if RTOS_FREERTOS
-    xTaskCreate(lwIPInterruptTask, (signed portCHAR *)"eth_int",
-                STACKSIZE_LWIPINTTASK, 0, tskIDLE_PRIORITY + 1,
-                0);
+    xTaskGenericCreate(lwIPInterruptTask, (signed portCHAR *)"eth_int",
+                       STACKSIZE_LWIPINTTASK, 0, LWIP_INTERRUPT_TASK_PRIO,
+                       0, g_puxLwIPIntStack, 0);
 #endif
 #endif
 
@@ -748,15 +1241,16 @@ lwIPPrivateInit(void *pvArg)
     //
     // Create, configure and add the Ethernet controller interface with
     // default settings.  ip_input should be used to send packets directly to
-    // the stack when not using a RTOS and tcpip_input should be used to send
-    // packets to the TCP/IP thread's queue when using a RTOS.
+    // the stack when not using a RTOS and tcpip_input (here through
+    // lwIPTCPIPInput) should be used to send packets to the TCP/IP thread's
+    // queue when using a RTOS.
     //
 #if NO_SYS
     netif_add(&g_sNetIF, &ip_addr, &net_mask, &gw_addr, NULL, tivaif_init,
               ip_input);
 #else
     netif_add(&g_sNetIF, &ip_addr, &net_mask, &gw_addr, NULL, tivaif_init,
-              tcpip_input);
+              lwIPTCPIPInput);
 #endif
     netif_set_default(&g_sNetIF);
 
@@ -1011,6 +1505,8 @@ lwIPEthernetIntHandler(void)
     portBASE_TYPE xWake;
 #endif
 
+    LWIP_INT_ENTER(INT_EMAC0);
+
     //
     // Read and Clear the interrupt.
     //
@@ -1054,6 +1550,7 @@ lwIPEthernetIntHandler(void)
     //
     if(ui32Status)
     {
+        lwIPRingSample(ui32Status);
         tivaif_interrupt(&g_sNetIF, ui32Status);
     }
 
@@ -1063,22 +1560,44 @@ lwIPEthernetIntHandler(void)
     lwIPServiceTimers();
 #else
     //
-    // A RTOS is being used.  Signal the Ethernet interrupt task.
+    // A RTOS is being used.  Note when the first packet was reported since
+    // the last one was passed to the stack.
     //
-    xQueueSendFromISR(g_pInterrupt, (void *)&ui32Status, &xWake);
+#if LWIP_INPUT_LATENCY
+    if((ui32Status & EMAC_INT_RECEIVE) && !g_bInputStamped)
+    {
+        g_ui32InputStamp = LWIP_LATENCY_NOW();
+        g_bInputStamped = true;
+    }
+#endif
+
+    //
+    // Add the status to that waiting for the Ethernet interrupt task and
+    // signal the task.  This interrupt has a lower priority than the kernel
+    // (it uses the FromISR API), so the task cannot be changing the status
+    // meanwhile.
+    //
+    xWake = pdFALSE;
+    if(ui32Status)
+    {
+        g_ui32IntStatus |= ui32Status;
+        xSemaphoreGiveFromISR(g_pInterrupt, &xWake);
+    }
 
     //
-    // Disable the Ethernet interrupts.  Since the interrupts have not been
-    // handled, they are not asserted.  Once they are handled by the Ethernet
-    // interrupt task, it will re-enable the interrupts.
+    // The receive and transmit interrupts stay enabled, so that packets
+    // arriving while the interrupt task runs are reported to it at once.
+    // Conditions that persist until the task has dealt with them (the PHY
+    // interrupt and the DMA running out of descriptors) are disabled until
+    // then, as they would otherwise interrupt again and again.
     //
-    MAP_EMACIntDisable(EMAC0_BASE, (EMAC_INT_RECEIVE | EMAC_INT_TRANSMIT |
-                                    EMAC_INT_TX_STOPPED |
-                                    EMAC_INT_RX_NO_BUFFER |
-                                    EMAC_INT_RX_STOPPED | EMAC_INT_PHY));
+    if(ui32Status & LWIP_INT_DEFERRED)
+    {
+        MAP_EMACIntDisable(EMAC0_BASE, ui32Status & LWIP_INT_DEFERRED);
+    }
 
     //
-    // Potentially task switch as a result of the above queue write.
+    // Potentially task switch as a result of the above semaphore give.
     //
 #if RTOS_FREERTOS
     if(xWake == pdTRUE)
@@ -1087,6 +1606,182 @@ lwIPEthernetIntHandler(void)
     }
 #endif
 #endif
+
+    LWIP_INT_EXIT(INT_EMAC0);
+}
+
+//*****************************************************************************
+//
+//! Returns the input latency histogram.
+//!
+//! \param psLatency is a pointer to the structure that receives a copy of the
+//! histogram.
+//!
+//! This function returns the distribution of the time from the Ethernet
+//! interrupt that reports a received packet to that packet being passed to
+//! the TCP/IP thread.  The histogram is empty unless \b LWIP_INPUT_LATENCY
+//! is set.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+lwIPInputLatencyGet(tLwIPLatency *psLatency)
+{
+#if !NO_SYS && LWIP_INPUT_LATENCY
+    taskENTER_CRITICAL();
+    *psLatency = g_sInputLatency;
+    taskEXIT_CRITICAL();
+#else
+    memset(psLatency, 0, sizeof(*psLatency));
+#endif
+}
+
+//*****************************************************************************
+//
+//! Returns the receive interrupt coalescing statistics.
+//!
+//! \param psStats is a pointer to the structure that receives a copy of the
+//! statistics.
+//!
+//! This function returns the counts kept when \b LWIP_RX_COALESCE is set, or
+//! zeros otherwise.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+lwIPRxStatsGet(tLwIPRxStats *psStats)
+{
+#if !NO_SYS && LWIP_RX_COALESCE
+    taskENTER_CRITICAL();
+    *psStats = g_sRxStats;
+    taskEXIT_CRITICAL();
+#else
+    memset(psStats, 0, sizeof(*psStats));
+#endif
+}
+
+//*****************************************************************************
+//
+// The lwIP memory pools reported by lwIPNetStatsGet(), in the order of the
+// LWIP_POOL_* indices.
+//
+//*****************************************************************************
+#if LWIP_STATS && MEMP_STATS
+static const uint8_t g_pui8NetStatsPools[LWIP_NUM_POOLS] =
+{
+    MEMP_PBUF, MEMP_PBUF_POOL, MEMP_TCP_PCB, MEMP_TCP_PCB_LISTEN, MEMP_TCP_SEG,
+    MEMP_SYS_TIMEOUT,
+#if NO_SYS
+    MEMP_MAX
+#else
+    MEMP_TCPIP_MSG_API
+#endif
+};
+#endif
+
+//*****************************************************************************
+//
+// Copies lwIP's statistics for the heap or a memory pool.
+//
+//*****************************************************************************
+#if LWIP_STATS && (MEM_STATS || MEMP_STATS)
+static void
+lwIPMemStatsCopy(tLwIPMemStats *psStats, const struct stats_mem *psMem)
+{
+    psStats->ui32Avail = psMem->avail;
+    psStats->ui32Used = psMem->used;
+    psStats->ui32Max = psMem->max;
+    psStats->ui32Err = psMem->err;
+}
+#endif
+
+//*****************************************************************************
+//
+// Copies lwIP's statistics for a protocol layer.
+//
+//*****************************************************************************
+#if LWIP_STATS
+static void
+lwIPProtoStatsCopy(tLwIPProtoStats *psStats, const struct stats_proto *psProto)
+{
+    psStats->ui32Xmit = psProto->xmit;
+    psStats->ui32Recv = psProto->recv;
+    psStats->ui32Drop = psProto->drop;
+    psStats->ui32ChkErr = psProto->chkerr;
+    psStats->ui32LenErr = psProto->lenerr;
+    psStats->ui32MemErr = psProto->memerr;
+    psStats->ui32RtErr = psProto->rterr;
+    psStats->ui32ProtErr = psProto->proterr;
+    psStats->ui32OptErr = psProto->opterr;
+    psStats->ui32Err = psProto->err;
+}
+#endif
+
+//*****************************************************************************
+//
+//! Returns the network stack statistics.
+//!
+//! \param psStats is a pointer to the structure that receives the
+//! statistics.
+//!
+//! This function returns the current use, high-water mark and allocation
+//! failures of the lwIP heap and memory pools, the packet and error counts of
+//! the Ethernet link, IP and TCP layers, and the use of the Ethernet DMA
+//! descriptor rings.  These are the figures against which the sizes in
+//! lwipopts.h can be checked.  Statistics that lwIP is not configured to keep
+//! are returned as zero.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+lwIPNetStatsGet(tLwIPNetStats *psStats)
+{
+#if LWIP_STATS && MEMP_STATS
+    uint32_t ui32Idx;
+#endif
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    memset(psStats, 0, sizeof(*psStats));
+
+    //
+    // The stack and the Ethernet interrupt handling update these as they
+    // run; take a consistent copy.
+    //
+    SYS_ARCH_PROTECT(lev);
+
+#if LWIP_STATS && MEM_STATS
+    lwIPMemStatsCopy(&psStats->sHeap, &lwip_stats.mem);
+#endif
+#if LWIP_STATS && MEMP_STATS
+    for(ui32Idx = 0; ui32Idx < LWIP_NUM_POOLS; ui32Idx++)
+    {
+        if(g_pui8NetStatsPools[ui32Idx] < MEMP_MAX)
+        {
+            lwIPMemStatsCopy(&psStats->psPools[ui32Idx],
+                             &lwip_stats.memp[g_pui8NetStatsPools[ui32Idx]]);
+        }
+    }
+#endif
+#if LWIP_STATS && LINK_STATS
+    lwIPProtoStatsCopy(&psStats->sLink, &lwip_stats.link);
+#endif
+#if LWIP_STATS && IP_STATS
+    lwIPProtoStatsCopy(&psStats->sIP, &lwip_stats.ip);
+#endif
+#if LWIP_STATS && TCP_STATS
+    lwIPProtoStatsCopy(&psStats->sTCP, &lwip_stats.tcp);
+#endif
+
+    psStats->sTxRing = g_sTxRing;
+    psStats->sRxRing = g_sRxRing;
+
+    SYS_ARCH_UNPROTECT(lev);
+
+    psStats->sTxRing.ui32Size = NUM_TX_DESCRIPTORS;
+    psStats->sRxRing.ui32Size = NUM_RX_DESCRIPTORS;
 }
 
 //*****************************************************************************
@@ -832,6 +832,313 @@ usnprintf(char * restrict s, size_t n, const char * restrict format, ...)
     return(ret);
 }
 
+//*****************************************************************************
+//
+// The two-digit decimal representations of 0 through 99, used to convert two
+// digits per division by the number formatting functions.
+//
+//*****************************************************************************
+static const char g_pcDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+//*****************************************************************************
+//
+// The powers of ten that can be used as a fixed-point scale.
+//
+//*****************************************************************************
+static const uint32_t g_pui32Pow10[10] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000
+};
+
+//*****************************************************************************
+//
+// Writes the decimal digits of a value backwards from the end of a buffer,
+// padding with zeros to at least the given number of digits.  Returns a
+// pointer to the first digit.
+//
+//*****************************************************************************
+static char *
+ufmtdigits(char *pcEnd, uint32_t ui32Value, uint32_t ui32MinDigits)
+{
+    char *pcStart;
+    uint32_t ui32Pair;
+
+    pcStart = pcEnd;
+
+    //
+    // Convert two digits at a time.
+    //
+    while(ui32Value >= 100)
+    {
+        ui32Pair = (ui32Value % 100) * 2;
+        ui32Value /= 100;
+        *--pcStart = g_pcDigitPairs[ui32Pair + 1];
+        *--pcStart = g_pcDigitPairs[ui32Pair];
+    }
+
+    //
+    // Convert the last one or two digits.
+    //
+    if(ui32Value >= 10)
+    {
+        ui32Pair = ui32Value * 2;
+        *--pcStart = g_pcDigitPairs[ui32Pair + 1];
+        *--pcStart = g_pcDigitPairs[ui32Pair];
+    }
+    else
+    {
+        *--pcStart = '0' + ui32Value;
+    }
+
+    //
+    // Pad with zeros as required.
+    //
+    while((uint32_t)(pcEnd - pcStart) < ui32MinDigits)
+    {
+        *--pcStart = '0';
+    }
+
+    return(pcStart);
+}
+
+//*****************************************************************************
+//
+//! Converts an unsigned value to a decimal string.
+//!
+//! \param s is the buffer where the converted string is stored.
+//! \param ui32Value is the value to convert.
+//!
+//! This function is a fast alternative to <tt>usprintf(s, "%u", value)</tt>;
+//! it does not parse a format string and converts two digits at a time.
+//!
+//! The caller must ensure that the buffer \e s can hold 11 characters.
+//!
+//! \return Returns the count of characters that were written to the output
+//! buffer, not including the NULL termination character.
+//
+//*****************************************************************************
+int
+uutoa(char *s, uint32_t ui32Value)
+{
+    char pcBuf[10];
+    char *pcDigits;
+    int iLen, iIdx;
+
+    pcDigits = ufmtdigits(pcBuf + sizeof(pcBuf), ui32Value, 1);
+    iLen = (pcBuf + sizeof(pcBuf)) - pcDigits;
+    for(iIdx = 0; iIdx < iLen; iIdx++)
+    {
+        s[iIdx] = pcDigits[iIdx];
+    }
+    s[iLen] = 0;
+
+    return(iLen);
+}
+
+//*****************************************************************************
+//
+//! Converts a signed value to a decimal string.
+//!
+//! \param s is the buffer where the converted string is stored.
+//! \param i32Value is the value to convert.
+//!
+//! This function is a fast alternative to <tt>usprintf(s, "%d", value)</tt>.
+//!
+//! The caller must ensure that the buffer \e s can hold 12 characters.
+//!
+//! \return Returns the count of characters that were written to the output
+//! buffer, not including the NULL termination character.
+//
+//*****************************************************************************
+int
+uitoa(char *s, int32_t i32Value)
+{
+    if(i32Value < 0)
+    {
+        *s = '-';
+        return(uutoa(s + 1, -(uint32_t)i32Value) + 1);
+    }
+
+    return(uutoa(s, (uint32_t)i32Value));
+}
+
+//*****************************************************************************
+//
+//! Converts a fixed-point value to a decimal string.
+//!
+//! \param s is the buffer where the converted string is stored.
+//! \param i32Value is the value to convert, in units of 10^-\e ui32Decimals.
+//! \param ui32Decimals is the number of digits after the decimal point, from
+//! 0 to 9.
+//!
+//! This function converts a fixed-point value, such as a temperature in
+//! hundredths of a degree, into a decimal string with exactly
+//! \e ui32Decimals digits after the decimal point.  For example, -125 with two
+//! decimals is converted to ``-1.25'' and -5 with one decimal to ``-0.5''.
+//!
+//! The caller must ensure that the buffer \e s can hold 13 characters.
+//!
+//! \return Returns the count of characters that were written to the output
+//! buffer, not including the NULL termination character.
+//
+//*****************************************************************************
+int
+ufixtoa(char *s, int32_t i32Value, uint32_t ui32Decimals)
+{
+    char pcBuf[12];
+    char *pcStart, *pcEnd;
+    uint32_t ui32Abs, ui32Scale;
+    int iLen, iIdx;
+
+    ASSERT(ui32Decimals < 10);
+
+    ui32Abs = (i32Value < 0) ? -(uint32_t)i32Value : (uint32_t)i32Value;
+    ui32Scale = g_pui32Pow10[ui32Decimals];
+
+    //
+    // Build the string backwards: the fraction, the decimal point, the
+    // integer part and the sign.
+    //
+    pcEnd = pcBuf + sizeof(pcBuf);
+    pcStart = pcEnd;
+    if(ui32Decimals)
+    {
+        pcStart = ufmtdigits(pcStart, ui32Abs % ui32Scale, ui32Decimals);
+        *--pcStart = '.';
+    }
+    pcStart = ufmtdigits(pcStart, ui32Abs / ui32Scale, 1);
+    if(i32Value < 0)
+    {
+        *--pcStart = '-';
+    }
+
+    iLen = pcEnd - pcStart;
+    for(iIdx = 0; iIdx < iLen; iIdx++)
+    {
+        s[iIdx] = pcStart[iIdx];
+    }
+    s[iLen] = 0;
+
+    return(iLen);
+}
+
+//*****************************************************************************
+//
+//! Converts a floating-point value to a decimal string.
+//!
+//! \param s is the buffer where the converted string is stored.
+//! \param fValue is the value to convert.
+//! \param ui32Decimals is the number of digits after the decimal point, from
+//! 0 to 9.
+//!
+//! This function rounds \e fValue to \e ui32Decimals digits after the decimal
+//! point (halves away from zero) and converts it as ufixtoa() does.  Values
+//! that do not fit in 32 bits once scaled are clamped.
+//!
+//! The caller must ensure that the buffer \e s can hold 13 characters.
+//!
+//! \return Returns the count of characters that were written to the output
+//! buffer, not including the NULL termination character.
+//
+//*****************************************************************************
+int
+uftoa(char *s, float fValue, uint32_t ui32Decimals)
+{
+    float fScaled;
+    int32_t i32Value;
+
+    ASSERT(ui32Decimals < 10);
+
+    fScaled = fValue * (float)g_pui32Pow10[ui32Decimals];
+    fScaled += (fScaled < 0) ? -0.5f : 0.5f;
+    if(fScaled >= 2147483647.0f)
+    {
+        i32Value = 2147483647;
+    }
+    else if(fScaled <= -2147483647.0f)
+    {
+        i32Value = -2147483647;
+    }
+    else
+    {
+        i32Value = (int32_t)fScaled;
+    }
+
+    return(ufixtoa(s, i32Value, ui32Decimals));
+}
+
+#ifdef USTDLIB_BENCHMARK
+//*****************************************************************************
+//
+//! Measures the number formatting functions against usprintf().
+//!
+//! \param pfnCycles is a function returning a free-running, incrementing
+//! cycle count, such as the DWT cycle counter.
+//! \param ui32Iterations is the number of values to format with each method.
+//! \param psResult receives the cycles taken by each method.
+//!
+//! This function is only built when USTDLIB_BENCHMARK is defined.  It formats
+//! the same sequence of values, which includes negative ones, into a scratch
+//! buffer four times: as integers with uitoa() and with usprintf() (``%d''),
+//! and in tenths with ufixtoa() and with usprintf() the way the application
+//! used to (``%d.%d'').
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ufmtbenchmark(uint32_t (*pfnCycles)(void), uint32_t ui32Iterations,
+              tUFmtBenchmark *psResult)
+{
+    char pcBuf[16];
+    uint32_t ui32Idx, ui32Start;
+    int32_t i32Value;
+
+    ui32Start = pfnCycles();
+    for(ui32Idx = 0; ui32Idx < ui32Iterations; ui32Idx++)
+    {
+        i32Value = (int32_t)(ui32Idx * 37) - 5000;
+        uitoa(pcBuf, i32Value);
+    }
+    psResult->ui32IntFast = pfnCycles() - ui32Start;
+
+    ui32Start = pfnCycles();
+    for(ui32Idx = 0; ui32Idx < ui32Iterations; ui32Idx++)
+    {
+        i32Value = (int32_t)(ui32Idx * 37) - 5000;
+        usprintf(pcBuf, "%d", i32Value);
+    }
+    psResult->ui32IntPrintf = pfnCycles() - ui32Start;
+
+    ui32Start = pfnCycles();
+    for(ui32Idx = 0; ui32Idx < ui32Iterations; ui32Idx++)
+    {
+        i32Value = (int32_t)(ui32Idx * 37) - 5000;
+        ufixtoa(pcBuf, i32Value, 1);
+    }
+    psResult->ui32FixFast = pfnCycles() - ui32Start;
+
+    ui32Start = pfnCycles();
+    for(ui32Idx = 0; ui32Idx < ui32Iterations; ui32Idx++)
+    {
+        i32Value = (int32_t)(ui32Idx * 37) - 5000;
+        usprintf(pcBuf, "%d.%d", i32Value / 10, i32Value % 10);
+    }
+    psResult->ui32FixPrintf = pfnCycles() - ui32Start;
+}
+#endif
+
 //*****************************************************************************
 //
 // This array contains the number of days in a year at the beginning of each
@@ -0,0 +1,118 @@
+//*****************************************************************************
+//
+// ustdlib.h - Prototypes for simple standard library functions.
+//
+// Copyright (c) 2007-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 2.0.1.11577 of the Tiva Utility Library.
+//
+//*****************************************************************************
+
+#ifndef __USTDLIB_H__
+#define __USTDLIB_H__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+//! \addtogroup ustdlib_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#ifdef USTDLIB_BENCHMARK
+//*****************************************************************************
+//
+// The cycles taken by each formatting method in ufmtbenchmark().
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32IntFast;
+    uint32_t ui32IntPrintf;
+    uint32_t ui32FixFast;
+    uint32_t ui32FixPrintf;
+}
+tUFmtBenchmark;
+#endif
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void ulocaltime(time_t timer, struct tm *tm);
+extern time_t umktime(struct tm *timeptr);
+extern int urand(void);
+extern int usnprintf(char * restrict s, size_t n, const char * restrict format,
+                     ...);
+extern int usprintf(char * restrict s, const char * restrict format, ...);
+extern void usrand(unsigned int seed);
+extern int ustrcasecmp(const char *s1, const char *s2);
+extern int ustrcmp(const char *s1, const char *s2);
+extern size_t ustrlen(const char *s);
+extern int ustrncasecmp(const char *s1, const char *s2, size_t n);
+extern int ustrncmp(const char *s1, const char *s2, size_t n);
+extern char *ustrncpy(char * restrict s1, const char * restrict s2,
+                      size_t n);
+extern char *ustrstr(const char *s1, const char *s2);
+extern float ustrtof(const char *nptr, const char **endptr);
+extern unsigned long int ustrtoul(const char * restrict nptr,
+                                  const char ** restrict endptr, int base);
+extern int uvsnprintf(char * restrict s, size_t n,
+                      const char * restrict format, va_list arg);
+extern int uutoa(char *s, uint32_t ui32Value);
+extern int uitoa(char *s, int32_t i32Value);
+extern int ufixtoa(char *s, int32_t i32Value, uint32_t ui32Decimals);
+extern int uftoa(char *s, float fValue, uint32_t ui32Decimals);
+#ifdef USTDLIB_BENCHMARK
+extern void ufmtbenchmark(uint32_t (*pfnCycles)(void),
+                          uint32_t ui32Iterations,
+                          tUFmtBenchmark *psResult);
+#endif
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __USTDLIB_H__